@@ -9,55 +9,427 @@
 #ifdef _WIN32
 #include <conio.h>
 #include <windows.h>
-#define CLEAR_SCREEN() system("cls")
-#define PAUSE() system("pause")
 #define GET_KEY() getch()
-#define SET_COLOR(color) SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), color)
+#include <io.h>
+#ifndef ENABLE_VIRTUAL_TERMINAL_PROCESSING
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+#define SYNC_FILE(file) _commit(_fileno(file))
+#define TRUNCATE_FILE(file, size) _chsize_s(_fileno(file), size)
+#define REPLACE_FILE(source, destination) (MoveFileExA(source, destination, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0)
+#define THREAD_HANDLE HANDLE
+#define START_THREAD(thread, function, argument) ((*(thread) = CreateThread(NULL, 0, function, argument, 0, NULL)) != NULL)
+#define JOIN_THREAD(thread) (WaitForSingleObject(thread, INFINITE), CloseHandle(thread))
 #else
 #include <termios.h>
 #include <unistd.h>
-#define CLEAR_SCREEN() system("clear")
-#define PAUSE() system("read -p 'Press any key to continue...' var")
-#define GET_KEY() getchar()
-#define SET_COLOR(color) printf("\033[0;%dm", color)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/ioctl.h>
+#include <poll.h>
+#include <pthread.h>
+#define SYNC_FILE(file) fsync(fileno(file))
+#define TRUNCATE_FILE(file, size) ftruncate(fileno(file), size)
+#define REPLACE_FILE(source, destination) (rename(source, destination) == 0)
+#define THREAD_HANDLE pthread_t
+#define START_THREAD(thread, function, argument) (pthread_create(thread, NULL, function, argument) == 0)
+#define JOIN_THREAD(thread) pthread_join(thread, NULL)
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define GREP_SSE2_TARGET __attribute__((target("sse2")))
+#define GREP_AVX2_TARGET __attribute__((target("avx2")))
+#define GREP_SIMD
+#endif
+
+#ifdef __GNUC__
+#define PREFETCH(address) __builtin_prefetch(address)
+#else
+#define PREFETCH(address) ((void)(address))
 #endif
 
+#include "translationsCatalog.h"
+
+#define NOTES_FILE "notes.txt"
+#define TRANSLATIONS_OVERRIDE_FILE "translations.override.txt"
+#define NOTES_JOURNAL_FILE "notes.journal"
+#define NOTES_TEXT_TEMP_FILE "notes.txt.tmp"
+#define NOTES_BINARY_FILE "notes.bin"
+#define NOTES_BINARY_TEMP_FILE "notes.bin.tmp"
+#define NOTES_BINARY_REJECTED_FILE "notes.bin.bad"
+#define NOTES_BINARY_MAGIC 0x42544f4eu
+#define NOTES_BINARY_VERSION 2
+#define NOTES_TEXT_HEADER "#notes|2\n"
+#define MINUTES_PER_DAY (24 * 60)
+#define ARENA_BLOCK_SIZE (64 * 1024)
+#define LATEST_NOTES_COUNT 10
+#define SEARCH_RESULTS_LIMIT 20
+#define TITLE_TRIGRAM_LIMIT 128
+#define FUZZY_RESULTS_LIMIT 10
+#define MESSAGE_BUFFER_SIZE 4096
+#define SCREEN_BUFFER_SIZE (64 * 1024)
+#define DEFAULT_SCREEN_ROWS 24
+#define NOTE_SUMMARY_LINES 7
+#define MENU_STACK_LIMIT 16
+#define INPUT_BUFFER_SIZE 256
+#define ESCAPE_SEQUENCE_DELAY_MS 50
+#define IDLE_TASK_DELAY_MS 500
+#define IDLE_TASK_NOTE_LIMIT 4096
+#define FILTER_TEXT_LIMIT 64
+#define FILTER_BATCH_SIZE 1024
+#define FILTER_PREFETCH_DISTANCE 32
+#define COMMAND_ARGUMENT_LIMIT 16
+#define COMMAND_NOT_FOUND 2
+#define COMMAND_INVALID 1
+#define COMMAND_WRITE_FAILED 3
+#define IMPORT_WORKER_LIMIT 8
+#define IMPORT_MIN_CHUNK_SIZE (1024 * 1024)
+#define IMPORT_ERROR_REPORT_LIMIT 20
+#define EXPORT_BUFFER_SIZE (1024 * 1024)
+#define NOTE_SEPARATOR "______________________________________________________\n"
+
+// Only used to parse and display dates; notes store a timestamp in minutes
+// since 01.01.1970 00:00 local time.
+struct Date
+{
+    int day;
+    int month;
+    int year;
+    int hour;
+    int minute;
+};
+
 struct Note
 {
+    uint64_t id;
     struct MenuItem *menuItem;
     char *title;
     char *content;
-    struct Date
-    {
-        int day;
-        int month;
-        int year;
-        int hour;
-        int minute;
-    } date;
+    int32_t timestamp;
+    // position of the title in the trigram index, once it is built
+    uint32_t trigramSlot;
 };
 
 struct NoteNode
 {
     struct Note *note;
+    struct NoteNode *previous;
     struct NoteNode *next;
 };
 
-struct TranslationNode
+struct NoteIndexEntry
 {
-    char *key;
-    char *value;
-    struct TranslationNode *next;
+    uint64_t key;
+    struct NoteNode *noteNode;
+};
+
+// A piece of a read buffer; the text is not NUL terminated.
+struct TextView
+{
+    const char *text;
+    size_t length;
+};
+
+// A note record as it sits in notes.txt or the journal, before its text is
+// copied anywhere.
+struct NoteRecordView
+{
+    uint64_t id;
+    struct TextView title;
+    struct TextView content;
+    int32_t timestamp;
+};
+
+struct DateIndexEntry
+{
+    int32_t timestamp;
+    uint64_t id;
+    struct NoteNode *noteNode;
+};
+
+// notes.bin: a header, recordCount fixed-width records, then a string heap
+// holding every NUL terminated title followed by every content, so mapping
+// the file and listing notes never faults in content pages.
+struct NotesFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t recordCount;
+    uint64_t heapOffset;
+    uint64_t heapSize;
+};
+
+struct NotesFileRecord
+{
+    uint64_t key;
+    uint64_t titleOffset;
+    uint64_t contentOffset;
+    uint32_t titleLength;
+    uint32_t contentLength;
+    int32_t timestamp;
+    int32_t reserved;
+};
+
+// Version 1 records stored the date as five separate fields.
+struct NotesFileRecordV1
+{
+    uint64_t key;
+    uint64_t titleOffset;
+    uint64_t contentOffset;
+    uint32_t titleLength;
+    uint32_t contentLength;
+    int32_t day;
+    int32_t month;
+    int32_t year;
+    int32_t hour;
+    int32_t minute;
+    int32_t reserved;
+};
+
+// Bump allocator: memory is handed out from large blocks and only given back
+// all at once by freeArena().
+struct ArenaBlock
+{
+    struct ArenaBlock *next;
+    size_t size;
+    size_t used;
+};
+
+struct Arena
+{
+    struct ArenaBlock *blocks;
+    size_t reserved;
+    size_t used;
+};
+
+// Fixed size items carved out of an arena, with a free list for reuse.
+struct Slab
+{
+    struct Arena arena;
+    void *freeList;
+    size_t itemSize;
+    size_t liveCount;
+};
+
+// Inverted index: each term keeps the notes it appears in, sorted by id,
+// with how many times it appears in each.
+struct SearchPosting
+{
+    uint64_t id;
+    uint32_t frequency;
+};
+
+struct SearchTerm
+{
+    uint64_t hash;
+    char *text;
+    size_t length;
+    struct SearchPosting *postings;
+    size_t postingCount;
+    size_t postingCapacity;
+};
+
+struct SearchResult
+{
+    uint64_t id;
+    uint32_t score;
+};
+
+// A live title or content; grep scans runs of these that sit next to each
+// other in memory and maps a hit back to its note.
+struct GrepSpan
+{
+    const char *text;
+    size_t length;
+    struct Note *note;
+};
+
+// Title trigram index. Every indexed title gets a new slot; posting lists
+// hold slots, so they stay sorted by appending.
+struct TrigramEntry
+{
+    uint32_t trigram;
+    uint32_t postingCount;
+    uint32_t postingCapacity;
+    uint32_t *postings;
+};
+
+struct FuzzyMatch
+{
+    struct Note *note;
+    double similarity;
+};
+
+// Placeholders a message template can use, written #title, #date, ...
+enum TemplateField
+{
+    TEMPLATE_TEXT,
+    TEMPLATE_TITLE,
+    TEMPLATE_CONTENT,
+    TEMPLATE_DATE,
+    TEMPLATE_TIME,
+    TEMPLATE_COUNT,
+    TEMPLATE_FIRST,
+    TEMPLATE_LAST,
+    TEMPLATE_FIELD_COUNT
+};
+
+// A translation split once into literal text and placeholders.
+struct TemplateSegment
+{
+    enum TemplateField field;
+    size_t length;
+    const char *text;
+};
+
+struct MessageTemplate
+{
+    const char *source;
+    size_t segmentCount;
+    struct TemplateSegment segments[];
+};
+
+// Caller owned output; text past the end is dropped but still counted.
+struct TextBuffer
+{
+    char *data;
+    size_t size;
+    size_t length;
+};
+
+// Rows whose title contains each prefix of what was typed. A new character
+// only rechecks the rows the shorter filter kept, and erasing one goes back
+// to the rows already kept for the shorter filter.
+struct RowFilter
+{
+    char text[FILTER_TEXT_LIMIT + 1];
+    size_t length;
+    bool typing;
+    uint32_t *rows[FILTER_TEXT_LIMIT + 1];
+    size_t rowCounts[FILTER_TEXT_LIMIT + 1];
+};
+
+// A screen sized window over every note in date order. Only the rows on the
+// current page are formatted, so drawing costs the same for any list length.
+// A fuzzy list shows the titles closest to the filter instead of the ones
+// containing it.
+struct NoteListView
+{
+    size_t count;
+    size_t selected;
+    size_t pageSize;
+    bool withContent;
+    bool fuzzy;
+    struct RowFilter filter;
+    struct FuzzyMatch matches[FUZZY_RESULTS_LIMIT];
+    size_t matchCount;
+};
+
+// Keys that are not a single character, numbered past every byte value.
+enum SpecialKey
+{
+    KEY_UP = 256,
+    KEY_DOWN,
+    KEY_LEFT,
+    KEY_RIGHT,
+    KEY_PAGE_UP,
+    KEY_PAGE_DOWN
+};
+
+// An open menu. Submenus are pushed on top of the menu they were opened
+// from and popped when an item that does not stay in the menu is chosen.
+struct MenuState
+{
+    struct MenuItem **items;
+    int itemCount;
+    int selectedItem;
+    bool drawn;
+    char *titleTranslationKey;
+    char *instructionsTranslationKey;
+    struct RowFilter filter;
+};
+
+struct ImportRecord
+{
+    char *title;
+    char *content;
+    int32_t timestamp;
+};
+
+struct ImportError
+{
+    const char *record;
+    const char *message;
+};
+
+// One worker's share of an import file, cut at record boundaries. Each
+// worker keeps the strings it unescapes in its own arena, which joins the
+// string arena once every worker is done.
+struct ImportChunk
+{
+    const char *start;
+    const char *end;
+    bool json;
+    bool header;
+    int32_t defaultTimestamp;
+    struct Arena strings;
+    struct ImportRecord *records;
+    size_t recordCount;
+    size_t recordCapacity;
+    struct ImportError *errors;
+    size_t errorCount;
+    size_t errorCapacity;
+};
+
+// Output collected in a fixed buffer and written out each time it fills up.
+struct OutputBuffer
+{
+    FILE *file;
+    char *data;
+    size_t size;
+    size_t length;
+    bool failed;
+};
+
+struct NoteMemoryStats
+{
+    size_t noteCount;
+    size_t recordBytes;
+    size_t stringBytes;
+    size_t stringReservedBytes;
+    size_t indexBytes;
+    size_t mappedBytes;
+};
+
+// translations.txt is compiled into builtinTranslations. Lines from the
+// optional override file go into an open addressing table keyed by the
+// translation key, with one value per language column, and win over the
+// built-in ones. getTranslation() hands out the stored value itself.
+struct TranslationEntry
+{
+    const char *key;
+    const char **values;
 };
 
 struct MenuItem
 {
     char *key;
-    char *title;
+    const char *title;
     bool getTranslation;
     void (*action)(void *);
 };
 
+// Languages are the value columns of the translation files, so an override
+// file with more columns adds languages; these are the ones built in.
+enum appLanguage
+{
+    ENGLISH,
+    ROMANIAN,
+    SPANISH
+};
+
 struct Config
 {
     int MAX_TITLE_LENGTH;
@@ -65,13 +437,8 @@ struct Config
     int MAX_CONTENT_LENGTH;
     int MAX_DATE_LENGTH;
     int MAX_NOTES_COUNT;
-    enum appLanguage
-    {
-        ENGLISH,
-        ROMANIAN,
-        SPANISH,
-        LAST_ELEMENT
-    } language;
+    int JOURNAL_COMPACT_THRESHOLD;
+    int language;
     enum appColor
     {
         RED = 12,
@@ -83,11 +450,96 @@ struct Config
 };
 
 static struct NoteNode *notesList = NULL;
+static struct Slab noteSlab = {{NULL, 0, 0}, NULL, sizeof(struct Note), 0};
+static struct Slab noteNodeSlab = {{NULL, 0, 0}, NULL, sizeof(struct NoteNode), 0};
+static struct Slab menuItemSlab = {{NULL, 0, 0}, NULL, sizeof(struct MenuItem), 0};
+static struct Arena stringArena = {NULL, 0, 0};
+static struct Arena searchTermArena = {NULL, 0, 0};
+static struct SearchTerm *searchTerms = NULL;
+static size_t searchTermCapacity = 0;
+static size_t searchTermCount = 0;
+static bool searchIndexReady = false;
+static struct NoteNode *searchIndexCursor = NULL;
+static struct GrepSpan *grepSpans = NULL;
+static size_t grepSpanCount = 0;
+static size_t grepSpanCapacity = 0;
+static bool grepSpansReady = false;
+static struct TrigramEntry *trigramEntries = NULL;
+static size_t trigramEntryCapacity = 0;
+static size_t trigramEntryCount = 0;
+static struct Note **trigramNotes = NULL;
+static uint8_t *trigramCounts = NULL;
+static uint16_t *trigramShared = NULL;
+static uint32_t trigramSlotCount = 0;
+static uint32_t trigramSlotCapacity = 0;
+static bool trigramIndexReady = false;
+static struct NoteNode *trigramIndexCursor = NULL;
+static struct NoteNode *notesListTail = NULL;
+static struct NoteIndexEntry *noteIndex = NULL;
+static size_t noteIndexCapacity = 0;
+static size_t noteIndexCount = 0;
+static uint64_t lastNoteId = 0;
+static struct DateIndexEntry *dateIndex = NULL;
+static size_t dateIndexCount = 0;
+static size_t dateIndexCapacity = 0;
+static bool dateIndexReady = false;
+static struct NoteNode *dateIndexCursor = NULL;
 static struct Note *currentStateNote = NULL;
 static struct Config *config = NULL;
-static struct TranslationNode *translations = NULL;
+static struct TranslationEntry *translations = NULL;
+static size_t translationCapacity = 0;
+static size_t translationCount = 0;
+static int translationLanguageCount = 0;
+static char *translationText = NULL;
+static struct Arena translationArena = {NULL, 0, 0};
+static char screenBuffer[SCREEN_BUFFER_SIZE];
+static char exportBuffer[EXPORT_BUFFER_SIZE];
+static struct MenuState menuStack[MENU_STACK_LIMIT];
+static int menuStackDepth = 0;
+static bool batchMode = false;
+static unsigned char inputBuffer[INPUT_BUFFER_SIZE];
+static size_t inputStart = 0;
+static size_t inputEnd = 0;
+#ifndef _WIN32
+static struct termios savedTerminal;
+static bool rawMode = false;
+#endif
+static size_t noteListLength = 0;
+static struct MessageTemplate **messageTemplates = NULL;
+static size_t messageTemplateCapacity = 0;
+static size_t messageTemplateCount = 0;
+static struct Arena messageTemplateArena = {NULL, 0, 0};
+static FILE *journalFile = NULL;
+static long journalSize = 0;
+static bool journalTorn = false;
+static char *notesMap = NULL;
+static size_t notesMapSize = 0;
+static uint32_t notesMapVersion = 0;
 
 void showMenu(struct MenuItem **, char *, char *);
+void initScreen();
+void clearScreen();
+void presentScreen();
+void setScreenColor(int);
+int readKey();
+void pauseScreen();
+int getScreenRows();
+const char *noteNumberValidator(void *);
+const char *dateBoundValidator(void *);
+void drawNoteList(struct NoteListView *, const char *, const char *);
+void showNoteList(void (*)(void *), const char *, const char *, bool, bool);
+struct Note *getNoteListNote(const struct NoteListView *, size_t);
+void drawMenuItem(const struct MenuItem *, bool);
+bool moveMenuSelection(struct MenuState *, int, int);
+size_t getFilteredRowCount(const struct RowFilter *, size_t);
+size_t getFilteredRow(const struct RowFilter *, size_t);
+void pushFilterCharacter(struct RowFilter *, char, size_t, const char *(*)(size_t, void *), void *);
+void popFilterCharacter(struct RowFilter *);
+void clearRowFilter(struct RowFilter *);
+bool handleFilterKey(struct RowFilter *, int, size_t, const char *(*)(size_t, void *), void *);
+void drawRowFilter(const struct RowFilter *);
+const char *getNoteListTitle(size_t, void *);
+const char *getMenuItemTitle(size_t, void *);
 void addNoteAction();
 void addNoteToList(struct Note *);
 void deleteNoteAction();
@@ -95,23 +547,170 @@ void editNoteAction();
 void viewNotes();
 void changeLanguageAction();
 void changeColorAction();
-char *generateId();
-void *getInput(char *, const char *(void *), bool);
-char *formatTime(int, int);
-char *formatDate(int, int, int);
-void handleMenuInput(struct MenuItem **, int *, void (*)(void *), char *, char *);
-void deleteNote(void *);
+uint64_t generateId();
+uint64_t reserveNoteIds(size_t);
+void *getInput(const char *, const char *(void *), bool);
+void formatTime(int32_t, char *);
+void formatDate(int32_t, char *);
+int32_t makeTimestamp(const struct Date *);
+void splitTimestamp(int32_t, struct Date *);
+int32_t currentTimestamp();
+bool parseDateFields(const char *, struct Date *);
+void handleMenuInput(struct MenuState *, int);
+void drawMenu(struct MenuState *);
+void runMenuLoop(int);
+void setRawMode(bool);
+bool waitForInput(int);
+int readInputByte();
+void readLine(char *, size_t);
+bool storeNewNote(struct Note *);
+bool updateNote(struct NoteNode *, const char *, const char *, const char *);
+const char *getCommandOption(int, char **, const char *);
+char *readStandardInput();
+void printNoteRecord(const struct Note *);
+void printNoteField(const char *);
+int addNoteCommand(int, char **);
+int editNoteCommand(int, char **);
+int deleteNoteCommand(int, char **);
+int listNotesCommand(int, char **);
+int queryNotesCommand(int, char **);
+int batchCommand();
+int importNotesCommand(int, char **);
+int exportNotesCommand(int, char **);
+void writeExportRecord(struct OutputBuffer *, const struct Note *, bool);
+void writeCsvField(struct OutputBuffer *, const char *);
+void writeJsonString(struct OutputBuffer *, const char *);
+void writeOutput(struct OutputBuffer *, const char *, size_t);
+void flushOutput(struct OutputBuffer *);
+int runCommand(int, char **);
+size_t getProcessorCount();
+const char *findImportBoundary(const char *, const char *, const char *, bool);
+void parseImportChunk(struct ImportChunk *);
+const char *parseCsvRecord(struct ImportChunk *, const char **, char **);
+const char *parseCsvField(struct ImportChunk *, const char **, char **);
+const char *parseJsonRecord(struct ImportChunk *, const char **, char **);
+const char *parseJsonString(struct ImportChunk *, const char **, const char *, char **);
+const char *skipJsonValue(const char *, const char *);
+const char *skipJsonSpace(const char *, const char *);
+bool readJsonHex(const char *, const char *, uint32_t *);
+void reportImportErrors(const char *, const struct ImportChunk *, size_t, size_t);
+#ifdef _WIN32
+DWORD WINAPI importWorker(LPVOID);
+#else
+void *importWorker(void *);
+#endif
+bool idleWorkPending();
+void runIdleTask();
+bool deleteNote(const char *);
+void deletePickedNote(void *);
 int getMenuItemCount(struct MenuItem **);
-void saveNotesInFile();
+bool saveNotesInFile();
+bool saveNotesAsText(const char *, const char *);
+bool commitTempFile(FILE *, const char *, const char *);
+bool loadNotesBinary();
+char *mapFile(const char *, size_t *);
+void unmapFile(char *, size_t);
+void loadNotesText(const char *);
+void linkNoteNode(struct Note *);
+void *arenaAllocate(struct Arena *, size_t, size_t);
+void arenaReserve(struct Arena *, size_t);
+void freeArena(struct Arena *);
+void mergeArena(struct Arena *, struct Arena *);
+void *slabAllocate(struct Slab *);
+void slabFree(struct Slab *, void *);
+void slabReserve(struct Slab *, size_t);
+void freeSlab(struct Slab *);
+void getNoteMemoryStats(struct NoteMemoryStats *);
+void memoryStatsAction();
+void freeNotesList();
+char *copyString(const char *, size_t);
+void updateNoteMenuTitle(struct Note *);
+void exportNotesAction();
+bool compactNotes();
+void compactNotesIfNeeded();
+bool appendJournalRecord(char, const struct Note *);
+bool replayJournal();
+void writeNoteRecord(FILE *, const struct Note *);
+size_t getTextHeaderLength(const char *, size_t);
+bool parseNoteRecord(const char **, const char *, struct NoteRecordView *);
+bool parseLegacyNoteRecord(const char **, const char *, struct NoteRecordView *);
+const char *parseRecordNumber(const char *, const char *, uint64_t *);
+const char *parseRecordTimestamp(const char *, const char *, int32_t *);
+const char *parseRecordText(const char *, const char *, struct TextView *);
+struct Note *copyNoteRecord(const struct NoteRecordView *);
+struct NoteNode *findNoteNode(uint64_t);
+uint64_t parseNoteKey(const char *);
+struct MenuItem *getNoteMenuItem(struct Note *);
+void buildDateIndex();
+void buildDateIndexSlice(size_t);
+void indexNoteDate(struct NoteNode *);
+void unindexNoteDate(const struct Note *);
+size_t findDateIndexPosition(int32_t, uint64_t);
+void printNoteSummary(const struct Note *);
+void printNotesInDateRange(int32_t, int32_t);
+void viewNotesByDateRange();
+void viewLatestNotes();
+const char *nextSearchWord(const char *, size_t *);
+uint64_t hashSearchWord(const char *, size_t);
+struct SearchTerm *findSearchTerm(const char *, size_t, bool);
+bool matchesSearchTerm(const struct SearchTerm *, const char *);
+size_t findSearchPosting(const struct SearchTerm *, uint64_t);
+void addSearchPosting(struct SearchTerm *, uint64_t);
+void buildSearchIndex();
+void buildSearchIndexSlice(size_t);
+void indexNoteText(const struct Note *);
+void unindexNoteText(const struct Note *);
+size_t intersectSearchTerms(struct SearchTerm **, size_t, struct SearchResult **);
+size_t mergeSearchResults(struct SearchResult **, size_t, struct SearchResult *, size_t);
+size_t searchNotes(const char *, struct SearchResult **, size_t);
+size_t skipSearchPostings(const struct SearchTerm *, size_t, uint64_t);
+void siftSearchResult(struct SearchResult *, size_t, size_t);
+void selectBestSearchResults(struct SearchResult *, size_t, size_t);
+const char *searchQueryValidator(void *);
+bool matchesPattern(const char *, const char *, size_t, bool);
+const char *findPatternScalar(const char *, const char *, const char *, size_t, bool);
+const char *findPattern(const char *, const char *, const char *, size_t, bool);
+void buildGrepSpans();
+size_t grepNotes(const char *, bool, uint64_t **);
+const char *grepPatternValidator(void *);
+void grepNotesAction();
+size_t getTitleTrigrams(const char *, uint32_t *);
+struct TrigramEntry *findTrigramEntry(uint32_t, bool);
+void buildTrigramIndex();
+void buildTrigramIndexSlice(size_t);
+void indexNoteTitle(struct Note *);
+void unindexNoteTitle(const struct Note *);
+void freeTrigramIndex();
+size_t findFuzzyTitles(const char *, struct FuzzyMatch *, size_t);
+void showNotePicker(void (*)(void *), char *);
+void grepMatchCase(void *);
+void grepIgnoreCase(void *);
+void runGrep(bool);
+void searchNotesAction();
+void freeSearchIndex();
+void reserveNoteIndex(size_t);
+void indexNoteNode(struct NoteNode *);
+void unindexNoteKey(uint64_t);
+void removeNoteFromList(uint64_t);
+void replaceNote(struct Note *);
 int getFileSize(FILE *);
+const char *skipLine(const char *, const char *);
 void getSystemDate(void *);
 void getDate(void *);
-void parseDate(char *, struct Date *);
+int32_t parseDate(const char *);
 void changeLanguage(void *);
 void changeColor(void *);
-void updateTranslations();
-char *getTranslation(const char *, bool);
-char *addDynamicValueToString(char *, char *);
+uint64_t hashTranslationKey(const char *);
+struct TranslationEntry *findTranslation(const char *, bool);
+const struct BuiltinTranslation *findBuiltinTranslation(const char *);
+const char *lookupTranslation(const char *, int);
+const char *getTranslation(const char *);
+struct MessageTemplate *compileMessageTemplate(const char *);
+const struct MessageTemplate *getMessageTemplate(const char *);
+void appendText(struct TextBuffer *, const char *, size_t);
+void renderTemplate(struct TextBuffer *, const struct MessageTemplate *, const char *const *);
+void printMessage(const char *, const char *const *);
+void formatNoteSummary(struct TextBuffer *, const struct Note *, bool);
 void printList();
 
 void exitApp()
@@ -126,11 +725,7 @@ void back()
 
 void restartCurrentStateNote()
 {
-    free(currentStateNote->menuItem->key);
-    free(currentStateNote->menuItem);
-    free(currentStateNote->title);
-    free(currentStateNote->content);
-    free(currentStateNote);
+    slabFree(&noteSlab, currentStateNote);
     currentStateNote = NULL;
 }
 
@@ -165,13 +760,7 @@ int getMenuItemCount(struct MenuItem **menuItems)
 
 void getSystemDate(void *_)
 {
-    time_t t = time(NULL);
-    struct tm *tm = localtime(&t);
-    currentStateNote->date.day = tm->tm_mday;
-    currentStateNote->date.month = tm->tm_mon + 1;
-    currentStateNote->date.year = tm->tm_year + 1900;
-    currentStateNote->date.hour = tm->tm_hour;
-    currentStateNote->date.minute = tm->tm_min;
+    currentStateNote->timestamp = currentTimestamp();
 }
 
 const char *titleValidator(void *input)
@@ -218,67 +807,114 @@ const char *contentValidator(void *input)
     return NULL;
 }
 
-const char *dateValidator(void *input)
+const char *searchQueryValidator(void *input)
 {
-    char *date = (char *)input;
-    int day, month, year, hour, minute;
+    size_t length;
+    if (input == NULL || nextSearchWord((char *)input, &length) == NULL)
+    {
+        return "Search must contain at least one word! \n";
+    }
+    return NULL;
+}
 
-    if (strlen(date) != config->MAX_DATE_LENGTH)
+const char *grepPatternValidator(void *input)
+{
+    if (input == NULL || strlen((char *)input) == 0)
     {
-        return "Invalid date format: must be in format dd.mm.yyyy hh:mm!";
+        return "Text must not be empty! \n";
     }
+    return NULL;
+}
 
-    if (sscanf(date, "%d/%d/%d %d:%d", &day, &month, &year, &hour, &minute) != 5)
+// Accepts a position in the list currently shown, counted from 1.
+const char *noteNumberValidator(void *input)
+{
+    char *number = (char *)input;
+    size_t position = 0;
+    if (number == NULL || *number == '\0')
+    {
+        return "Number must not be empty! \n";
+    }
+    for (char *c = number; *c != '\0'; c++)
+    {
+        if (!isdigit((unsigned char)*c) || position > noteListLength)
+        {
+            return "Number is not in the list! \n";
+        }
+        position = position * 10 + (*c - '0');
+    }
+    if (position == 0 || position > noteListLength)
     {
-        return "Invalid date format: must be in format dd.mm.yyyy hh:mm!";
+        return "Number is not in the list! \n";
     }
+    return NULL;
+}
 
-    time_t t = time(NULL);
-    struct tm *tm = localtime(&t);
+// filter bounds only need a real date; the timestamp must fit in 32 bits
+const char *dateBoundValidator(void *input)
+{
+    char *date = (char *)input;
+    struct Date fields;
+    static const int daysInMonth[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
 
-    if (hour < 0 || hour > 23)
+    if (strlen(date) != config->MAX_DATE_LENGTH || !parseDateFields(date, &fields))
     {
-        return "Hour must be between 0 and 23! \n";
+        return "Invalid date format: must be in format dd/mm/yyyy hh:mm! \n";
     }
 
-    if (day == tm->tm_mday && month == tm->tm_mon + 1 && year == tm->tm_year + 1900 && hour > tm->tm_hour)
+    if (fields.hour < 0 || fields.hour > 23)
     {
-        return "Hour must be less than current hour!s \n";
+        return "Hour must be between 0 and 23! \n";
     }
 
-    if (minute < 0 || minute > 59)
+    if (fields.minute < 0 || fields.minute > 59)
     {
         return "Minute must be between 0 and 59! \n";
     }
 
-    if (day == tm->tm_mday && month == tm->tm_mon + 1 && year == tm->tm_year + 1900 && hour == tm->tm_hour && minute > tm->tm_min)
+    if (fields.month < 1 || fields.month > 12)
     {
-        return "Minute must be less than current minute! \n";
+        return "Month must be between 1 and 12! \n";
     }
 
-    if (day < 1 || day > 31)
+    if (fields.day < 1 || fields.day > daysInMonth[fields.month - 1])
     {
-        return "Day must be between 1 and 31! \n";
+        return "Day is not valid for this month! \n";
     }
 
-    if (day > tm->tm_mday && month == tm->tm_mon + 1 && year == tm->tm_year + 1900)
+    if (fields.year < 1900)
     {
-        return "Day must be less than current day! \n";
+        return "Year must be between 1900 and current year! \n";
     }
 
-    if (month < 1 || month > 12)
+    if (fields.year > 4000)
     {
-        return "Month must be between 1 and 12! \n";
+        return "Year must not be after 4000! \n";
     }
 
-    if (month > tm->tm_mon + 1 && year == tm->tm_year + 1900)
+    // 29.02 of a non leap year comes back as 01.03
+    int32_t timestamp = makeTimestamp(&fields);
+    struct Date normalized;
+    splitTimestamp(timestamp, &normalized);
+    if (normalized.day != fields.day)
     {
-        return "Month must be less than current month! \n";
+        return "Day is not valid for this month! \n";
     }
 
-    if (year < 1900 || year > tm->tm_year + 1900)
+    return NULL;
+}
+
+const char *dateValidator(void *input)
+{
+    const char *error = dateBoundValidator(input);
+    if (error != NULL)
     {
-        return "Year must be between 1900 and current year! \n";
+        return error;
+    }
+
+    if (parseDate((char *)input) > currentTimestamp())
+    {
+        return "Date must not be in the future! \n";
     }
 
     return NULL;
@@ -286,996 +922,5046 @@ const char *dateValidator(void *input)
 
 void getDate(void *_)
 {
-    CLEAR_SCREEN();
-    char *dateText = getInput(getTranslation("getInputDate", true), dateValidator, false);
-    struct Date *date = malloc(sizeof(struct Date));
-    parseDate(dateText, date);
-    currentStateNote->date.day = date->day;
-    currentStateNote->date.month = date->month;
-    currentStateNote->date.year = date->year;
-    currentStateNote->date.hour = date->hour;
-    currentStateNote->date.minute = date->minute;
-    free(date);
+    clearScreen();
+    char *dateText = getInput(getTranslation("getInputDate"), dateValidator, false);
+    currentStateNote->timestamp = parseDate(dateText);
     free(dateText);
 }
 
-void parseDate(char *dateString, struct Date *date)
+// Accepts dd/mm/yyyy hh:mm as well as dd.mm.yyyy hh:mm.
+bool parseDateFields(const char *text, struct Date *date)
 {
-    char dayStr[3], monthStr[3], yearStr[5], hourStr[3], minuteStr[3];
-    int i = 0, j = 0;
-    while (dateString[i] != '.' && i < 2)
-        dayStr[j++] = dateString[i++];
-    dayStr[j] = '\0';
-    i++;
-
-    j = 0;
-    while (dateString[i] != '.' && i < 5)
-        monthStr[j++] = dateString[i++];
-    monthStr[j] = '\0';
-    i++;
-    j = 0;
-
-    while (dateString[i] != ' ' && i < 10)
-        yearStr[j++] = dateString[i++];
-    yearStr[j] = '\0';
-    i++;
-    j = 0;
-
-    while (dateString[i] != ':' && i < 13)
-        hourStr[j++] = dateString[i++];
-    hourStr[j] = '\0';
-    i++;
-    j = 0;
-
-    while (dateString[i] != ':' && i < config->MAX_DATE_LENGTH)
-        minuteStr[j++] = dateString[i++];
-    minuteStr[j] = '\0';
-
-    date->day = atoi(dayStr);
-    date->month = atoi(monthStr);
-    date->year = atoi(yearStr);
-    date->hour = atoi(hourStr);
-    date->minute = atoi(minuteStr);
+    char separator[2][2];
+    return sscanf(text, "%d%1[./]%d%1[./]%d %d:%d", &date->day, separator[0], &date->month, separator[1], &date->year, &date->hour, &date->minute) == 7;
 }
 
-void addNoteToList(struct Note *note)
+int32_t parseDate(const char *dateString)
 {
-    struct NoteNode *NoteNode = malloc(sizeof(struct NoteNode));
-    struct Note *noteCopy = malloc(sizeof(struct Note));
-    noteCopy->title = malloc(sizeof(char *) * config->MAX_TITLE_LENGTH);
-    noteCopy->content = malloc(sizeof(char *) * config->MAX_CONTENT_LENGTH);
-    noteCopy->menuItem = malloc(sizeof(struct MenuItem));
-    noteCopy->menuItem->key = malloc(sizeof(char *) * 11);
-    noteCopy->menuItem->title = malloc(sizeof(char *) * config->MAX_TITLE_LENGTH);
-    strcpy(noteCopy->title, note->title);
-    strcpy(noteCopy->content, note->content);
-    strcpy(noteCopy->menuItem->key, note->menuItem->key);
-    strcpy(noteCopy->menuItem->title, note->menuItem->title);
-    noteCopy->date.day = note->date.day;
-    noteCopy->date.month = note->date.month;
-    noteCopy->date.year = note->date.year;
-    noteCopy->date.hour = note->date.hour;
-    noteCopy->date.minute = note->date.minute;
-    NoteNode->note = noteCopy;
-    NoteNode->next = NULL;
-    if (notesList == NULL)
-    {
-        notesList = NoteNode;
-    }
-    else
+    struct Date date;
+    if (!parseDateFields(dateString, &date))
     {
-        struct NoteNode *current = notesList;
-        while (current->next != NULL)
-        {
-            current = current->next;
-        }
-        current->next = NoteNode;
+        return 0;
     }
-    free(note);
+    return makeTimestamp(&date);
 }
 
-void getDateAction()
+// Days from civil date and back, see http://howardhinnant.github.io/date_algorithms.html
+int32_t makeTimestamp(const struct Date *date)
 {
-    struct MenuItem **menuItem = malloc(sizeof(struct MenuItem *) * 3);
-    menuItem[0] = malloc(sizeof(struct MenuItem));
-    menuItem[0]->key = "addDateFunction";
-    menuItem[0]->title = NULL;
-    menuItem[0]->action = getDate;
-    menuItem[0]->getTranslation = true;
-    menuItem[1] = malloc(sizeof(struct MenuItem));
-    menuItem[1]->key = "getSystemDateFunction";
-    menuItem[1]->title = NULL;
-    menuItem[1]->action = getSystemDate;
-    menuItem[1]->getTranslation = true;
-    menuItem[2] = NULL;
-    showMenu(menuItem, "getDateActionTitle", "getDateActionIndication");
-
+    int year = date->year - (date->month <= 2);
+    int era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = (unsigned)(year - era * 400);
+    unsigned dayOfYear = (153 * (date->month > 2 ? date->month - 3 : date->month + 9) + 2) / 5 + date->day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    int32_t days = era * 146097 + (int32_t)dayOfEra - 719468;
+    return days * MINUTES_PER_DAY + date->hour * 60 + date->minute;
 }
 
-void addNoteAction()
+void splitTimestamp(int32_t timestamp, struct Date *date)
 {
-    CLEAR_SCREEN();
-    currentStateNote = malloc(sizeof(struct Note));
-    currentStateNote->title = malloc(config->MAX_TITLE_LENGTH * sizeof(char));
-    currentStateNote->content = malloc(config->MAX_CONTENT_LENGTH * sizeof(char));
-    strcpy(currentStateNote->title, (char *)getInput(getTranslation("getInputNoteTitle", true), titleValidator, false));
-    CLEAR_SCREEN();
-    strcpy(currentStateNote->content, (char *)getInput(getTranslation("getInputNoteContent", true), contentValidator, false));
-    getDateAction();
-    CLEAR_SCREEN();
-    currentStateNote->menuItem = malloc(sizeof(struct MenuItem));
-    currentStateNote->menuItem->key = malloc(sizeof(char) * 11);
-    currentStateNote->menuItem->title = malloc(sizeof(char) * (config->MAX_TITLE_LENGTH + config->MAX_DATE_LENGTH + 5));
-    strcpy(currentStateNote->menuItem->key, generateId());
-    char *menuTitle = malloc((config->MAX_TITLE_LENGTH + config->MAX_DATE_LENGTH + 5) * sizeof(char));
-    sprintf(menuTitle, "%s - %s", currentStateNote->title, formatDate(currentStateNote->date.day, currentStateNote->date.month, currentStateNote->date.year));
-    strcpy(currentStateNote->menuItem->title, menuTitle);
-    currentStateNote->menuItem->action = NULL;
-    addNoteToList(currentStateNote);
-    saveNotesInFile();
-    printf("%s", getTranslation("noteAddedSuccessfully", true));
-    free(menuTitle);
-    PAUSE();
-}
-
-void saveNotesInFile()
-{
-    FILE *file = fopen("notes.txt", "w");
-    if (file == NULL)
-    {
-        return;
-    }
-    struct NoteNode *current = notesList;
-    while (current != NULL)
+    int32_t days = timestamp / MINUTES_PER_DAY;
+    int32_t minutes = timestamp % MINUTES_PER_DAY;
+    if (minutes < 0)
     {
-        fprintf(file, "%s|%s|%s|%d|%d|%d|%d|%d\n", current->note->menuItem->key, current->note->title, current->note->content, current->note->date.day, current->note->date.month, current->note->date.year, current->note->date.hour, current->note->date.minute);
-        current = current->next;
+        minutes += MINUTES_PER_DAY;
+        days--;
     }
-    fclose(file);
+    date->hour = minutes / 60;
+    date->minute = minutes % 60;
+    days += 719468;
+    int era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned dayOfEra = (unsigned)(days - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    date->day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    date->month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    date->year = (int)yearOfEra + era * 400 + (date->month <= 2);
 }
 
-void saveConfig()
+// localtime() is only consulted once, for the offset between UTC and local
+// wall clock minutes.
+int32_t currentTimestamp()
 {
-    FILE *file = fopen("config.txt", "w");
-    if (file == NULL)
+    static bool offsetReady = false;
+    static int32_t offset = 0;
+    time_t now = time(NULL);
+    if (!offsetReady)
     {
-        return;
+        struct tm *tm = localtime(&now);
+        struct Date date = {tm->tm_mday, tm->tm_mon + 1, tm->tm_year + 1900, tm->tm_hour, tm->tm_min};
+        offset = makeTimestamp(&date) - (int32_t)(now / 60);
+        offsetReady = true;
     }
-    fprintf(file, "maxTitleLength|%d\n", config->MAX_TITLE_LENGTH);
-    fprintf(file, "maxContentLength|%d\n", config->MAX_CONTENT_LENGTH);
-    fprintf(file, "maxDateLength|%d\n", config->MAX_DATE_LENGTH);
-    fprintf(file, "maxMessageLength|%d\n", config->MAX_MESSAGE_LENGTH);
-    fprintf(file, "color|%d\n", (int)config->color);
-    fprintf(file, "language|%d\n", (int)config->language);
-    fclose(file);
+    return (int32_t)(now / 60) + offset;
 }
 
-void editNote(void *key)
+void *arenaAllocate(struct Arena *arena, size_t size, size_t alignment)
 {
-    CLEAR_SCREEN();
-    char *noteKey = (char *)key;
-    struct NoteNode *currentNoteNode = notesList;
-    while (currentNoteNode != NULL)
+    struct ArenaBlock *block = arena->blocks;
+    size_t offset = block == NULL ? 0 : (block->used + alignment - 1) & ~(alignment - 1);
+    if (block == NULL || offset + size > block->size)
     {
-        if (strcmp(currentNoteNode->note->menuItem->key, noteKey) == 0)
-        {
-            void *newValue = NULL;
-            printf("%s", addDynamicValueToString(getTranslation("currentTitle", true), currentNoteNode->note->title));
-            newValue = getInput(getTranslation("getInputNewNoteTitle", true), titleValidator, true);
-            if (newValue != NULL)
-            {
-                currentNoteNode->note->title = realloc(currentNoteNode->note->title, sizeof(char *) * strlen(newValue));
-                currentNoteNode->note->title = newValue;
-            }
-            newValue = NULL;
-            CLEAR_SCREEN();
-            printf("%s", addDynamicValueToString(getTranslation("currentContent", true), currentNoteNode->note->content));
-            newValue = getInput(getTranslation("getInputNewNoteContent", true), contentValidator, true);
-            if (newValue != NULL)
-            {
-                currentNoteNode->note->content = realloc(currentNoteNode->note->content, sizeof(char *) * strlen(newValue));
-                currentNoteNode->note->content = newValue;
-            }
-            CLEAR_SCREEN();
-            printf("%s", addDynamicValueToString(getTranslation("currentDate", true), formatDate(currentNoteNode->note->date.day, currentNoteNode->note->date.month, currentNoteNode->note->date.year)));
-            newValue = getInput(getTranslation("getInputNewNoteDate", true), dateValidator, true);
-            if (newValue != NULL)
-            {
-                struct Date *newDate = malloc(sizeof(struct Date));
-                parseDate((char *)newValue, newDate);
-                currentNoteNode->note->date.day = newDate->day;
-                currentNoteNode->note->date.month = newDate->month;
-                currentNoteNode->note->date.year = newDate->year;
-                currentNoteNode->note->date.hour = newDate->hour;
-                currentNoteNode->note->date.minute = newDate->minute;
-                free(newDate);
-            }
-            char *menuTitle = malloc(sizeof(char *) * config->MAX_TITLE_LENGTH + config->MAX_DATE_LENGTH + 3);
-            sprintf(menuTitle, "%s - %s", currentNoteNode->note->title, formatDate(currentNoteNode->note->date.day, currentNoteNode->note->date.month, currentNoteNode->note->date.year));
-            currentNoteNode->note->menuItem->title = menuTitle;
-            saveNotesInFile();
-            CLEAR_SCREEN();
-            printf("%s", getTranslation("noteEditedSuccessfully", true));
-            PAUSE();
-            return;
-        }
-        currentNoteNode = currentNoteNode->next;
+        arenaReserve(arena, size);
+        block = arena->blocks;
+        offset = 0;
     }
+    block->used = offset + size;
+    arena->used += size;
+    return (char *)(block + 1) + offset;
 }
 
-void deleteNote(void *key)
+// Makes sure the current block has room for size more bytes, so a bulk load
+// can get all of its records from a single block.
+void arenaReserve(struct Arena *arena, size_t size)
 {
-    char *noteKey = (char *)key;
-    struct NoteNode *currentNoteNode = notesList;
-    struct NoteNode *previousNoteNode = NULL;
-    while (currentNoteNode != NULL)
+    struct ArenaBlock *block = arena->blocks;
+    if (block != NULL && block->size - block->used >= size)
     {
-        if (strcmp(currentNoteNode->note->menuItem->key, noteKey) == 0)
-        {
-            if (previousNoteNode == NULL)
-            {
-                notesList = currentNoteNode->next;
-            }
-            else
-            {
-                previousNoteNode->next = currentNoteNode->next;
-            }
-            free(currentNoteNode->note->menuItem);
-            free(currentNoteNode->note->title);
-            free(currentNoteNode->note->content);
-            free(currentNoteNode->note);
-            free(currentNoteNode);
-            saveNotesInFile();
-            return;
-        }
-        previousNoteNode = currentNoteNode;
-        currentNoteNode = currentNoteNode->next;
+        return;
     }
+    size_t blockSize = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+    block = malloc(sizeof(struct ArenaBlock) + blockSize);
+    block->next = arena->blocks;
+    block->size = blockSize;
+    block->used = 0;
+    arena->blocks = block;
+    arena->reserved += sizeof(struct ArenaBlock) + blockSize;
 }
 
-char *generateId()
+// Hands the blocks of from over to into, behind the block into is filling.
+void mergeArena(struct Arena *into, struct Arena *from)
 {
-    char *id = malloc(11);
-    for (int i = 0; i < 10; i++)
+    if (from->blocks == NULL)
+    {
+        return;
+    }
+    struct ArenaBlock *last = from->blocks;
+    while (last->next != NULL)
     {
-        id[i] = (rand() % 10) + 48;
+        last = last->next;
     }
-    if (notesList == NULL)
+    if (into->blocks == NULL)
     {
-        return id;
+        into->blocks = from->blocks;
     }
     else
     {
-        const struct NoteNode *currentNoteNode = notesList;
-        while (currentNoteNode != NULL)
-        {
-
-            if (strcmp(currentNoteNode->note->menuItem->key, id) == 0)
-            {
-                return generateId();
-            }
-            currentNoteNode = currentNoteNode->next;
-        }
+        last->next = into->blocks->next;
+        into->blocks->next = from->blocks;
     }
-    id[11] = '\0';
-    return id;
+    into->reserved += from->reserved;
+    into->used += from->used;
+    from->blocks = NULL;
+    from->reserved = 0;
+    from->used = 0;
 }
 
-void *getInput(char *message, const char *(validator)(void *), bool canBeEmpty)
+void freeArena(struct Arena *arena)
 {
-    void *input = NULL;
-    char buffer[256];
-    printf("%s", message);
-    fgets(buffer, 255, stdin);
-    input = (void *)malloc(strlen(buffer) + 1);
-    buffer[strlen(buffer) - 1] = '\0';
-    strcpy(input, buffer);
-    if (canBeEmpty && strlen(buffer) == 0)
-    {
-        return NULL;
-    }
-    while (validator(input) != NULL)
+    while (arena->blocks != NULL)
     {
-
-        CLEAR_SCREEN();
-        printf("%s", getTranslation("invalidInput", true));
-        printf("%s", validator(input));
-        printf("%s", message);
-        fgets(buffer, 255, stdin);
-        buffer[strlen(buffer) - 1] = '\0';
-        input = realloc(input, strlen(buffer) + 1);
-        strcpy(input, buffer);
+        struct ArenaBlock *next = arena->blocks->next;
+        free(arena->blocks);
+        arena->blocks = next;
     }
-    free(message);
-    return input;
+    arena->reserved = 0;
+    arena->used = 0;
 }
 
-void viewNotesByDate() {
-    CLEAR_SCREEN();
-    struct Date *date = malloc(sizeof(struct Date));
-    char *input = getInput(getTranslation("getInputDate", true), dateValidator, false);
-    parseDate(input, date);
-    CLEAR_SCREEN();
-    const struct NoteNode *currentNoteNode = notesList;
-    if (currentNoteNode == NULL)
-    {
-        printf("%s", getTranslation("noNotesFound", true));
-        PAUSE();
-        return;
-    }
-    while (currentNoteNode != NULL)
+void *slabAllocate(struct Slab *slab)
+{
+    slab->liveCount++;
+    if (slab->freeList != NULL)
     {
-        if (currentNoteNode == notesList)
-            printf("______________________________________________________\n");
-        if (currentNoteNode->note->date.day == date->day && currentNoteNode->note->date.month == date->month && currentNoteNode->note->date.year == date->year)
-        {
-            printf("-%s", getTranslation("noteInfo", true));
-            printf("      -%s", addDynamicValueToString(getTranslation("title", true), currentNoteNode->note->title));
-            printf("      -%s", getTranslation("dateInfo", true));
-            printf("         -%s", addDynamicValueToString(getTranslation("date", true), formatDate(currentNoteNode->note->date.day, currentNoteNode->note->date.month, currentNoteNode->note->date.year)));
-            printf("         -%s", addDynamicValueToString(getTranslation("time", true), formatTime(currentNoteNode->note->date.hour, currentNoteNode->note->date.minute)));
-            printf("______________________________________________________\n");
-        }
-        currentNoteNode = currentNoteNode->next;
+        void *item = slab->freeList;
+        slab->freeList = *(void **)item;
+        return item;
     }
-    free(date);
-    PAUSE();
+    return arenaAllocate(&slab->arena, slab->itemSize, sizeof(void *));
 }
 
-void viewNotes()
+void slabFree(struct Slab *slab, void *item)
 {
-    const struct NoteNode *currentNoteNode = notesList;
-    CLEAR_SCREEN();
-    if (currentNoteNode == NULL)
-    {
-        printf("%s", getTranslation("noNotesFound", true));
-        PAUSE();
-        return;
-    }
-    while (currentNoteNode != NULL)
-    {
-        if (currentNoteNode == notesList)
-            printf("______________________________________________________\n");
-        printf("-%s", getTranslation("noteInfo", true));
-        printf("      -%s", addDynamicValueToString(getTranslation("title", true), currentNoteNode->note->title));
-        printf("      -%s", getTranslation("dateInfo", true));
-        printf("         -%s", addDynamicValueToString(getTranslation("date", true), formatDate(currentNoteNode->note->date.day, currentNoteNode->note->date.month, currentNoteNode->note->date.year)));
-        printf("         -%s", addDynamicValueToString(getTranslation("time", true), formatTime(currentNoteNode->note->date.hour, currentNoteNode->note->date.minute)));
-        printf("      -%s", addDynamicValueToString(getTranslation("content", true), currentNoteNode->note->content));
-        printf("______________________________________________________\n");
-        currentNoteNode = currentNoteNode->next;
-    }
-    PAUSE();
+    *(void **)item = slab->freeList;
+    slab->freeList = item;
+    slab->liveCount--;
 }
 
-char *formatDate(int day, int month, int year)
+void slabReserve(struct Slab *slab, size_t count)
 {
-    char *date = malloc(11);
-    if (day < 10)
-    {
-        date[0] = '0';
-        date[1] = day + 48;
-    }
-    else
-    {
-        date[0] = (day / 10) + 48;
-        date[1] = (day % 10) + 48;
-    }
-    date[2] = '.';
-    if (month < 10)
+    arenaReserve(&slab->arena, count * slab->itemSize);
+}
+
+void freeSlab(struct Slab *slab)
+{
+    freeArena(&slab->arena);
+    slab->freeList = NULL;
+    slab->liveCount = 0;
+}
+
+// Note strings live in the string arena; replaced ones stay there until the
+// notes are reloaded.
+char *copyString(const char *source, size_t length)
+{
+    char *copy = arenaAllocate(&stringArena, length + 1, 1);
+    memcpy(copy, source, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void getNoteMemoryStats(struct NoteMemoryStats *stats)
+{
+    stats->noteCount = noteSlab.liveCount;
+    stats->recordBytes = noteSlab.arena.reserved + noteNodeSlab.arena.reserved + menuItemSlab.arena.reserved;
+    stats->stringBytes = stringArena.used;
+    stats->stringReservedBytes = stringArena.reserved;
+    stats->indexBytes = noteIndexCapacity * sizeof(struct NoteIndexEntry) + dateIndexCapacity * sizeof(struct DateIndexEntry) +
+                        searchTermCapacity * sizeof(struct SearchTerm) + searchTermArena.reserved;
+    for (size_t i = 0; i < searchTermCapacity; i++)
     {
-        date[3] = '0';
-        date[4] = month + 48;
+        stats->indexBytes += searchTerms[i].postingCapacity * sizeof(struct SearchPosting);
     }
-    else
+    stats->indexBytes += grepSpanCapacity * sizeof(struct GrepSpan);
+    stats->indexBytes += trigramEntryCapacity * sizeof(struct TrigramEntry) +
+                         trigramSlotCapacity * (sizeof(struct Note *) + sizeof(uint8_t) + sizeof(uint16_t));
+    for (size_t i = 0; i < trigramEntryCapacity; i++)
     {
-        date[3] = (month / 10) + 48;
-        date[4] = (month % 10) + 48;
+        stats->indexBytes += trigramEntries[i].postingCapacity * sizeof(uint32_t);
     }
-    date[5] = '.';
-    date[6] = (year / 1000) + 48;
-    date[7] = ((year / 100) % 10) + 48;
-    date[8] = ((year / 10) % 10) + 48;
-    date[9] = (year % 10) + 48;
-    date[10] = '\0';
-    return date;
+    stats->mappedBytes = notesMapSize;
 }
 
-char *formatTime(int hour, int minute)
+// Menu titles are built on first use by the edit and delete pickers, so
+// loading notes never has to read their titles.
+void updateNoteMenuTitle(struct Note *note)
 {
-    char *time = malloc(6);
-    if (hour < 10)
+    if (note->menuItem == NULL)
     {
-        time[0] = '0';
-        time[1] = hour + 48;
+        return;
     }
-    else
+    char date[11];
+    formatDate(note->timestamp, date);
+    char *menuTitle = arenaAllocate(&stringArena, strlen(note->title) + strlen(date) + 4, 1);
+    sprintf(menuTitle, "%s - %s", note->title, date);
+    note->menuItem->title = menuTitle;
+}
+
+// The list takes ownership of the note and its strings.
+void addNoteToList(struct Note *note)
+{
+    linkNoteNode(note);
+}
+
+void linkNoteNode(struct Note *note)
+{
+    struct NoteNode *NoteNode = slabAllocate(&noteNodeSlab);
+    NoteNode->note = note;
+    NoteNode->previous = notesListTail;
+    NoteNode->next = NULL;
+    indexNoteNode(NoteNode);
+    indexNoteDate(NoteNode);
+    indexNoteText(note);
+    indexNoteTitle(note);
+    grepSpansReady = false;
+    if (note->id > lastNoteId)
     {
-        time[0] = (hour / 10) + 48;
-        time[1] = (hour % 10) + 48;
+        lastNoteId = note->id;
     }
-    time[2] = ':';
-    if (minute < 10)
+    if (notesList == NULL)
     {
-        time[3] = '0';
-        time[4] = minute + 48;
+        notesList = NoteNode;
     }
     else
     {
-        time[3] = (minute / 10) + 48;
-        time[4] = (minute % 10) + 48;
+        notesListTail->next = NoteNode;
     }
-    time[5] = '\0';
-    return time;
+    notesListTail = NoteNode;
 }
 
-void changeColorAction()
+void getDateAction()
 {
-    struct MenuItem **menuItems = malloc(sizeof(struct MenuItem *) * 7);
-
-    struct MenuItem *redMenuItem = malloc(sizeof(struct MenuItem));
-    redMenuItem->title = NULL;
-    redMenuItem->key = malloc(sizeof(char) * 3);
-    redMenuItem->getTranslation = true;
-    sprintf(redMenuItem->key, "%d", RED);
-    redMenuItem->action = changeColor;
-    menuItems[0] = redMenuItem;
-
-    struct MenuItem *greenMenuItem = malloc(sizeof(struct MenuItem));
-    greenMenuItem->title = NULL;
-    greenMenuItem->key = malloc(sizeof(char) * 3);
-    greenMenuItem->getTranslation = true;
-    sprintf(greenMenuItem->key, "%d", GREEN);
-    greenMenuItem->action = changeColor;
-    menuItems[1] = greenMenuItem;
-
-    struct MenuItem *blueMenuItem = malloc(sizeof(struct MenuItem));
-    blueMenuItem->title = NULL;
-    blueMenuItem->key = malloc(sizeof(char) * 3);
-    blueMenuItem->getTranslation = true;
-    sprintf(blueMenuItem->key, "%d", BLUE);
-    blueMenuItem->action = changeColor;
-    menuItems[2] = blueMenuItem;
+    struct MenuItem **menuItem = malloc(sizeof(struct MenuItem *) * 3);
+    menuItem[0] = malloc(sizeof(struct MenuItem));
+    menuItem[0]->key = "addDateFunction";
+    menuItem[0]->title = NULL;
+    menuItem[0]->action = getDate;
+    menuItem[0]->getTranslation = true;
+    menuItem[1] = malloc(sizeof(struct MenuItem));
+    menuItem[1]->key = "getSystemDateFunction";
+    menuItem[1]->title = NULL;
+    menuItem[1]->action = getSystemDate;
+    menuItem[1]->getTranslation = true;
+    menuItem[2] = NULL;
+    showMenu(menuItem, "getDateActionTitle", "getDateActionIndication");
 
-    struct MenuItem *yellowMenuItem = malloc(sizeof(struct MenuItem));
-    yellowMenuItem->title = NULL;
-    yellowMenuItem->key = malloc(sizeof(char) * 3);
-    yellowMenuItem->getTranslation = true;
-    sprintf(yellowMenuItem->key, "%d", YELLOW);
-    yellowMenuItem->action = changeColor;
-    menuItems[3] = yellowMenuItem;
+}
 
-    struct MenuItem *whiteMenuItem = malloc(sizeof(struct MenuItem));
-    whiteMenuItem->title = NULL;
-    whiteMenuItem->key = malloc(sizeof(char) * 2);
-    whiteMenuItem->getTranslation = true;
-    sprintf(whiteMenuItem->key, "%d", WHITE);
-    whiteMenuItem->action = changeColor;
-    menuItems[4] = whiteMenuItem;
+void addNoteAction()
+{
+    clearScreen();
+    currentStateNote = slabAllocate(&noteSlab);
+    char *input = getInput(getTranslation("getInputNoteTitle"), titleValidator, false);
+    currentStateNote->title = copyString(input, strlen(input));
+    free(input);
+    clearScreen();
+    input = getInput(getTranslation("getInputNoteContent"), contentValidator, false);
+    currentStateNote->content = copyString(input, strlen(input));
+    free(input);
+    getDateAction();
+    clearScreen();
+    bool stored = storeNewNote(currentStateNote);
+    currentStateNote = NULL;
+    printf("%s\n", getTranslation(stored ? "noteAddedSuccessfully" : "noteSaveFailed"));
+    pauseScreen();
+}
 
-    struct MenuItem *backMenuItem = malloc(sizeof(struct MenuItem));
-    backMenuItem->title = NULL;
-    backMenuItem->key = "back";
-    backMenuItem->getTranslation = true;
-    backMenuItem->action = back;
-    menuItems[5] = backMenuItem;
+// Snapshots are written to a temporary file and renamed into place, so a crash
+// leaves either the old or the new snapshot, never a partial one.
+bool commitTempFile(FILE *file, const char *tempPath, const char *path)
+{
+    bool written = fflush(file) == 0 && SYNC_FILE(file) == 0 && !ferror(file);
+    fclose(file);
+    if (!written || !REPLACE_FILE(tempPath, path))
+    {
+        remove(tempPath);
+        return false;
+    }
+#ifndef _WIN32
+    int directory = open(".", O_RDONLY);
+    if (directory != -1)
+    {
+        fsync(directory);
+        close(directory);
+    }
+#endif
+    return true;
+}
 
-    menuItems[6] = NULL;
+bool saveNotesInFile()
+{
+    FILE *file = fopen(NOTES_BINARY_TEMP_FILE, "wb");
+    if (file == NULL)
+    {
+        return false;
+    }
+    struct NotesFileHeader header = {0};
+    header.magic = NOTES_BINARY_MAGIC;
+    header.version = NOTES_BINARY_VERSION;
+    for (struct NoteNode *current = notesList; current != NULL; current = current->next)
+    {
+        header.recordCount++;
+        header.heapSize += strlen(current->note->title) + strlen(current->note->content) + 2;
+    }
+    header.heapOffset = sizeof(struct NotesFileHeader) + header.recordCount * sizeof(struct NotesFileRecord);
+    fwrite(&header, sizeof(header), 1, file);
 
-    showMenu(menuItems, "changeColorActionTitle", "changeColorActionIndication");
+    uint64_t titleOffset = 0;
+    uint64_t contentOffset = 0;
+    for (struct NoteNode *current = notesList; current != NULL; current = current->next)
+    {
+        contentOffset += strlen(current->note->title) + 1;
+    }
+    for (struct NoteNode *current = notesList; current != NULL; current = current->next)
+    {
+        struct NotesFileRecord record = {0};
+        record.key = current->note->id;
+        record.titleLength = strlen(current->note->title);
+        record.contentLength = strlen(current->note->content);
+        record.titleOffset = titleOffset;
+        record.contentOffset = contentOffset;
+        record.timestamp = current->note->timestamp;
+        titleOffset += record.titleLength + 1;
+        contentOffset += record.contentLength + 1;
+        fwrite(&record, sizeof(record), 1, file);
+    }
+    for (struct NoteNode *current = notesList; current != NULL; current = current->next)
+    {
+        fwrite(current->note->title, strlen(current->note->title) + 1, 1, file);
+    }
+    for (struct NoteNode *current = notesList; current != NULL; current = current->next)
+    {
+        fwrite(current->note->content, strlen(current->note->content) + 1, 1, file);
+    }
+    return commitTempFile(file, NOTES_BINARY_TEMP_FILE, NOTES_BINARY_FILE);
 }
 
-void changeLanguageAction()
+bool saveNotesAsText(const char *tempPath, const char *path)
 {
-    struct MenuItem **menuItems = malloc(sizeof(struct MenuItem *) * (LAST_ELEMENT + 2));
-    for (int i = 0; i < LAST_ELEMENT; i++)
+    FILE *file = fopen(tempPath, "wb");
+    if (file == NULL)
     {
-        struct MenuItem *languageMenuItem = malloc(sizeof(struct MenuItem));
-        languageMenuItem->title = "Language";
-        char* key = malloc(sizeof(char) * 2);
-        sprintf(key, "%d", i);
-        languageMenuItem->key = key;
-        languageMenuItem->action = changeLanguage;
-        languageMenuItem->getTranslation = true;
-        menuItems[i] = languageMenuItem;
+        return false;
     }
-    struct MenuItem *backMenuItem = malloc(sizeof(struct MenuItem));
-    backMenuItem->title = NULL;
-    backMenuItem->key = "back";
-    backMenuItem->action = back;
-    backMenuItem->getTranslation = true;
-    menuItems[LAST_ELEMENT] = backMenuItem;
-    menuItems[LAST_ELEMENT + 1] = NULL;
-
-    showMenu(menuItems, "changeLanguageActionTitle", "changeLanguageActionIndication");
+    fputs(NOTES_TEXT_HEADER, file);
+    struct NoteNode *current = notesList;
+    while (current != NULL)
+    {
+        writeNoteRecord(file, current->note);
+        current = current->next;
+    }
+    return commitTempFile(file, tempPath, path);
 }
 
+// Records are id|titleLength:title|contentLength:content|timestamp with the
+// lengths in bytes, so the text may hold | and line breaks.
+void writeNoteRecord(FILE *file, const struct Note *note)
+{
+    fprintf(file, "%llu|%zu:%s|%zu:%s|%d\n", (unsigned long long)note->id, strlen(note->title), note->title, strlen(note->content), note->content, note->timestamp);
+}
 
-void changeColor(void *color)
+// Replaying a journal on top of the snapshot it was folded into is harmless,
+// so the journal is only cleared once the new snapshot is in place.
+bool compactNotes()
 {
-    config->color = atoi(color);
-    SET_COLOR(config->color);
-    saveConfig();
-    CLEAR_SCREEN();
-    printf("%s", getTranslation("colorChangedSuccessfully", true));
-    PAUSE();
+    if (!saveNotesInFile())
+    {
+        return false;
+    }
+    if (journalFile != NULL)
+    {
+        fclose(journalFile);
+    }
+    journalFile = fopen(NOTES_JOURNAL_FILE, "wb");
+    journalSize = 0;
+    journalTorn = false;
+    if (journalFile != NULL)
+    {
+        fputs(NOTES_TEXT_HEADER, journalFile);
+        journalSize = ftell(journalFile);
+    }
+    return true;
 }
 
-void changeLanguage(void *language)
+// A batch syncs and compacts once at its end instead of after every change.
+void compactNotesIfNeeded()
 {
-    switch (atoi(language))
+    if (!batchMode && journalSize > config->JOURNAL_COMPACT_THRESHOLD)
     {
-    case 0:
-        config->language = ENGLISH;
-        break;
-    case 1:
-        config->language = ROMANIAN;
-        break;
-    case 2:
-        config->language = SPANISH;
-        break;
-    default:
-        config->language = ENGLISH;
-        break;
+        compactNotes();
     }
-    saveConfig();
-    updateTranslations();
 }
 
-void settingsAction()
+void memoryStatsAction()
 {
-    struct MenuItem **menuItems = malloc(sizeof(struct MenuItem *) * 4);
-    struct MenuItem *changeColor = malloc(sizeof(struct MenuItem));
-    changeColor->title = NULL;
-    changeColor->key = "changeColorActionTitle";
-    changeColor->action = changeColorAction;
-    changeColor->getTranslation = true;
-    menuItems[0] = changeColor;
+    struct NoteMemoryStats stats;
+    getNoteMemoryStats(&stats);
+    size_t heapBytes = stats.recordBytes + stats.stringReservedBytes + stats.indexBytes;
+    clearScreen();
+    printf("%s\n", getTranslation("memoryStatsAction"));
+    printf("%s: %zu\n", getTranslation("statsNotes"), stats.noteCount);
+    printf("%s: %zu\n", getTranslation("statsRecordBytes"), stats.recordBytes);
+    printf("%s: %zu / %zu\n", getTranslation("statsStringBytes"), stats.stringBytes, stats.stringReservedBytes);
+    printf("%s: %zu\n", getTranslation("statsIndexBytes"), stats.indexBytes);
+    printf("%s: %zu\n", getTranslation("statsMappedBytes"), stats.mappedBytes);
+    printf("%s: %zu\n", getTranslation("statsBytesPerNote"), stats.noteCount == 0 ? 0 : heapBytes / stats.noteCount);
+    pauseScreen();
+}
 
-    struct MenuItem *changeLanguage = malloc(sizeof(struct MenuItem));
-    changeLanguage->title = NULL;
-    changeLanguage->key = "changeLanguageActionTitle";
-    changeLanguage->action = changeLanguageAction;
-    changeLanguage->getTranslation = true;
-    menuItems[1] = changeLanguage;
+void exportNotesAction()
+{
+    clearScreen();
+    if (saveNotesAsText(NOTES_TEXT_TEMP_FILE, NOTES_FILE))
+    {
+        printf("%s\n", getTranslation("notesExported"));
+    }
+    else
+    {
+        printf("%s\n", getTranslation("notesExportFailed"));
+    }
+    pauseScreen();
+}
 
-    struct MenuItem *backMenuItem = malloc(sizeof(struct MenuItem));
-    backMenuItem->title = NULL;
-    backMenuItem->key = "back";
-    backMenuItem->action = back;
-    backMenuItem->getTranslation = true;
-    menuItems[2] = backMenuItem;
+// Journal records are 'A' (add), 'E' (edit) or 'D' (delete) followed by the note
+// fields; each one is flushed to disk before the in-memory list changes, which
+// is left alone when this returns false.
+bool appendJournalRecord(char operation, const struct Note *note)
+{
+    if (journalFile == NULL)
+    {
+        journalFile = fopen(NOTES_JOURNAL_FILE, "ab");
+        if (journalFile == NULL)
+        {
+            return false;
+        }
+        fseek(journalFile, 0, SEEK_END);
+        if (ftell(journalFile) == 0)
+        {
+            fputs(NOTES_TEXT_HEADER, journalFile);
+        }
+        journalSize = ftell(journalFile);
+    }
+    // a failed write may have left part of a record; cut it off before the next
+    if (journalTorn)
+    {
+        if (fflush(journalFile) != 0 || TRUNCATE_FILE(journalFile, journalSize) != 0)
+        {
+            clearerr(journalFile);
+            return false;
+        }
+        journalTorn = false;
+    }
+    if (operation == 'D')
+    {
+        fprintf(journalFile, "D|%llu\n", (unsigned long long)note->id);
+    }
+    else
+    {
+        fprintf(journalFile, "%c|", operation);
+        writeNoteRecord(journalFile, note);
+    }
+    bool written = fflush(journalFile) == 0 && !ferror(journalFile) && (batchMode || SYNC_FILE(journalFile) == 0);
+    clearerr(journalFile);
+    journalTorn = !written;
+    if (written)
+    {
+        journalSize = ftell(journalFile);
+    }
+    return written;
+}
 
-    menuItems[3] = NULL;
+// Returns true when the journal was written by an older version, without the
+// header; it has to be compacted before new records are appended to it. The
+// first record that does not parse was cut short by a crash: replay stops
+// there and the file is cut back to it, since its text may hold line breaks
+// that look like records. Old journals are still read line by line.
+bool replayJournal()
+{
+    size_t size = 0;
+    char *data = mapFile(NOTES_JOURNAL_FILE, &size);
+    if (data == NULL)
+    {
+        return false;
+    }
+    const char *end = data + size;
+    const char *position = data + getTextHeaderLength(data, size);
+    bool legacy = position == data;
+    journalSize = size;
+    while (position < end)
+    {
+        const char *record = position + 2;
+        struct NoteRecordView view;
+        uint64_t id;
+        bool valid = end - position >= 3 && position[1] == '|' && (!legacy || memchr(position, '\n', end - position) != NULL);
+        if (valid && position[0] == 'D')
+        {
+            const char *current = parseRecordNumber(record, end, &id);
+            valid = current != NULL && current < end && *current == '\n';
+            if (valid)
+            {
+                removeNoteFromList(id);
+                position = current + 1;
+                continue;
+            }
+        }
+        else if (valid && (position[0] == 'A' || position[0] == 'E' || legacy))
+        {
+            valid = legacy ? parseLegacyNoteRecord(&record, end, &view) : parseNoteRecord(&record, end, &view);
+            if (valid)
+            {
+                replaceNote(copyNoteRecord(&view));
+                position = record;
+                continue;
+            }
+        }
+        if (!legacy)
+        {
+            break;
+        }
+        position = skipLine(position, end);
+    }
+    size_t completeSize = position - data;
+    while (legacy && completeSize > 0 && data[completeSize - 1] != '\n')
+    {
+        completeSize--;
+    }
+    unmapFile(data, size);
+    if (completeSize < size)
+    {
+        FILE *file = fopen(NOTES_JOURNAL_FILE, "r+b");
+        if (file == NULL || TRUNCATE_FILE(file, completeSize) != 0 || SYNC_FILE(file) != 0)
+        {
+            journalTorn = true;
+        }
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        journalSize = completeSize;
+    }
+    return legacy;
+}
 
-    showMenu(menuItems, "settingsActionTitle", "settingActionIndication");
+void saveConfig()
+{
+    FILE *file = fopen("config.txt", "w");
+    if (file == NULL)
+    {
+        return;
+    }
+    fprintf(file, "maxTitleLength|%d\n", config->MAX_TITLE_LENGTH);
+    fprintf(file, "maxContentLength|%d\n", config->MAX_CONTENT_LENGTH);
+    fprintf(file, "maxDateLength|%d\n", config->MAX_DATE_LENGTH);
+    fprintf(file, "maxMessageLength|%d\n", config->MAX_MESSAGE_LENGTH);
+    fprintf(file, "color|%d\n", (int)config->color);
+    fprintf(file, "language|%d\n", (int)config->language);
+    fprintf(file, "journalCompactThreshold|%d\n", config->JOURNAL_COMPACT_THRESHOLD);
+    fclose(file);
 }
 
-void editNoteAction()
+void editNote(void *key)
 {
-    if (notesList == NULL)
+    clearScreen();
+    struct NoteNode *currentNoteNode = findNoteNode(parseNoteKey((char *)key));
+    if (currentNoteNode == NULL)
     {
-        CLEAR_SCREEN();
-        printf("%s", getTranslation("noNotesFound", true));
-        PAUSE();
         return;
     }
-    const struct NoteNode *currentNoteNode = notesList;
-    struct MenuItem **menuItems = malloc(sizeof(struct MenuItem *));
-    int menuItemsCount = 0;
-    while (currentNoteNode != NULL)
+    const char *values[TEMPLATE_FIELD_COUNT] = {NULL};
+    values[TEMPLATE_TITLE] = currentNoteNode->note->title;
+    printMessage("currentTitle", values);
+    char *newTitle = getInput(getTranslation("getInputNewNoteTitle"), titleValidator, true);
+    clearScreen();
+    values[TEMPLATE_CONTENT] = currentNoteNode->note->content;
+    printMessage("currentContent", values);
+    char *newContent = getInput(getTranslation("getInputNewNoteContent"), contentValidator, true);
+    clearScreen();
+    char currentDate[11];
+    formatDate(currentNoteNode->note->timestamp, currentDate);
+    values[TEMPLATE_DATE] = currentDate;
+    printMessage("currentDate", values);
+    char *newDate = getInput(getTranslation("getInputNewNoteDate"), dateValidator, true);
+    bool updated = updateNote(currentNoteNode, newTitle, newContent, newDate);
+    free(newTitle);
+    free(newContent);
+    free(newDate);
+    clearScreen();
+    printf("%s\n", getTranslation(updated ? "noteEditedSuccessfully" : "noteSaveFailed"));
+    pauseScreen();
+}
+
+// Gives a new note its id, journals it and adds it to the list.
+// When the note cannot be journaled it is freed and false is returned.
+bool storeNewNote(struct Note *note)
+{
+    note->id = generateId();
+    note->menuItem = NULL;
+    if (!appendJournalRecord('A', note))
     {
-        currentNoteNode->note->menuItem->action = editNote;
-        currentNoteNode->note->menuItem->getTranslation = false;
-        menuItems[menuItemsCount] = currentNoteNode->note->menuItem;
-        menuItemsCount++;
-        menuItems = realloc(menuItems, (menuItemsCount + 1) * sizeof(struct MenuItem *));
-        currentNoteNode = currentNoteNode->next;
+        slabFree(&noteSlab, note);
+        return false;
     }
-    menuItems = realloc(menuItems, (menuItemsCount + 2) * sizeof(struct MenuItem *));
-    struct MenuItem *backMenuItem = malloc(sizeof(struct MenuItem));
-    backMenuItem->title = NULL;
-    backMenuItem->key = "back";
-    backMenuItem->action = back;
-    backMenuItem->getTranslation = true;
-    menuItems[menuItemsCount] = backMenuItem;
-    menuItems[menuItemsCount + 1] = NULL;
-    showMenu(menuItems, "editNoteActionTitle", "editNoteActionIndication");
+    addNoteToList(note);
+    compactNotesIfNeeded();
+    return true;
 }
 
-void deleteNoteAction()
+// NULL leaves a field as it is; the new values must already be validated.
+// The edited note is journaled before the one in the list changes, which
+// stays as it was when that fails.
+bool updateNote(struct NoteNode *noteNode, const char *title, const char *content, const char *date)
 {
-    if (notesList == NULL)
+    struct Note edited = *noteNode->note;
+    if (title != NULL)
+    {
+        edited.title = copyString(title, strlen(title));
+    }
+    if (content != NULL)
+    {
+        edited.content = copyString(content, strlen(content));
+    }
+    if (date != NULL)
+    {
+        edited.timestamp = parseDate(date);
+    }
+    if (!appendJournalRecord('E', &edited))
+    {
+        return false;
+    }
+    unindexNoteText(noteNode->note);
+    unindexNoteTitle(noteNode->note);
+    noteNode->note->title = edited.title;
+    noteNode->note->content = edited.content;
+    if (date != NULL)
+    {
+        unindexNoteDate(noteNode->note);
+        noteNode->note->timestamp = edited.timestamp;
+        indexNoteDate(noteNode);
+    }
+    indexNoteText(noteNode->note);
+    indexNoteTitle(noteNode->note);
+    grepSpansReady = false;
+    updateNoteMenuTitle(noteNode->note);
+    compactNotesIfNeeded();
+    return true;
+}
+
+uint64_t parseNoteKey(const char *key)
+{
+    return strtoull(key, NULL, 10);
+}
+
+// Note menu items are only needed by the edit and delete pickers, so they
+// are created the first time a note is listed there.
+struct MenuItem *getNoteMenuItem(struct Note *note)
+{
+    if (note->menuItem == NULL)
+    {
+        char key[21];
+        note->menuItem = slabAllocate(&menuItemSlab);
+        note->menuItem->key = copyString(key, sprintf(key, "%llu", (unsigned long long)note->id));
+        note->menuItem->title = NULL;
+        note->menuItem->action = NULL;
+        note->menuItem->getTranslation = false;
+    }
+    if (note->menuItem->title == NULL)
+    {
+        updateNoteMenuTitle(note);
+    }
+    return note->menuItem;
+}
+
+// splitmix64 finalizer, spreads sequential and clustered keys over the table
+size_t hashNoteKey(uint64_t key)
+{
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return (size_t)key;
+}
+
+// Open addressing with linear probing, kept at most half full.
+void reserveNoteIndex(size_t count)
+{
+    size_t capacity = noteIndexCapacity == 0 ? 64 : noteIndexCapacity;
+    while (capacity < count * 2)
+    {
+        capacity *= 2;
+    }
+    if (capacity == noteIndexCapacity)
+    {
+        return;
+    }
+    struct NoteIndexEntry *oldIndex = noteIndex;
+    size_t oldCapacity = noteIndexCapacity;
+    noteIndex = calloc(capacity, sizeof(struct NoteIndexEntry));
+    noteIndexCapacity = capacity;
+    noteIndexCount = 0;
+    for (size_t i = 0; i < oldCapacity; i++)
+    {
+        if (oldIndex[i].noteNode != NULL)
+        {
+            indexNoteNode(oldIndex[i].noteNode);
+        }
+    }
+    free(oldIndex);
+}
+
+void indexNoteNode(struct NoteNode *noteNode)
+{
+    reserveNoteIndex(noteIndexCount + 1);
+    uint64_t key = noteNode->note->id;
+    size_t mask = noteIndexCapacity - 1;
+    size_t slot = hashNoteKey(key) & mask;
+    while (noteIndex[slot].noteNode != NULL && noteIndex[slot].key != key)
+    {
+        slot = (slot + 1) & mask;
+    }
+    if (noteIndex[slot].noteNode == NULL)
+    {
+        noteIndexCount++;
+    }
+    noteIndex[slot].key = key;
+    noteIndex[slot].noteNode = noteNode;
+}
+
+// Backward shift deletion keeps probe chains intact without tombstones.
+void unindexNoteKey(uint64_t key)
+{
+    if (noteIndexCapacity == 0)
+    {
+        return;
+    }
+    size_t mask = noteIndexCapacity - 1;
+    size_t slot = hashNoteKey(key) & mask;
+    while (noteIndex[slot].noteNode != NULL && noteIndex[slot].key != key)
+    {
+        slot = (slot + 1) & mask;
+    }
+    if (noteIndex[slot].noteNode == NULL)
+    {
+        return;
+    }
+    size_t next = (slot + 1) & mask;
+    while (noteIndex[next].noteNode != NULL)
+    {
+        size_t home = hashNoteKey(noteIndex[next].key) & mask;
+        if (((next - home) & mask) >= ((next - slot) & mask))
+        {
+            noteIndex[slot] = noteIndex[next];
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+    noteIndex[slot].noteNode = NULL;
+    noteIndexCount--;
+}
+
+struct NoteNode *findNoteNode(uint64_t noteKey)
+{
+    if (noteIndexCapacity == 0)
+    {
+        return NULL;
+    }
+    size_t mask = noteIndexCapacity - 1;
+    size_t slot = hashNoteKey(noteKey) & mask;
+    while (noteIndex[slot].noteNode != NULL)
+    {
+        if (noteIndex[slot].key == noteKey)
+        {
+            return noteIndex[slot].noteNode;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+int compareDateIndexEntries(const void *first, const void *second)
+{
+    const struct DateIndexEntry *a = first;
+    const struct DateIndexEntry *b = second;
+    if (a->timestamp != b->timestamp)
+    {
+        return a->timestamp < b->timestamp ? -1 : 1;
+    }
+    return a->id < b->id ? -1 : a->id > b->id;
+}
+
+// First position whose (timestamp, id) is not less than the one given.
+size_t findDateIndexPosition(int32_t timestamp, uint64_t id)
+{
+    size_t low = 0;
+    size_t high = dateIndexCount;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        const struct DateIndexEntry *entry = &dateIndex[middle];
+        if (entry->timestamp < timestamp || (entry->timestamp == timestamp && entry->id < id))
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+// The date index is sorted by (timestamp, id). It is built on the first date
+// query and kept up to date by every add, edit and delete after that.
+void buildDateIndex()
+{
+    buildDateIndexSlice(SIZE_MAX);
+}
+
+// Collects up to limit more notes, starting where the last call stopped, and
+// sorts them once every note is in.
+void buildDateIndexSlice(size_t limit)
+{
+    if (dateIndexReady)
+    {
+        return;
+    }
+    if (dateIndexCursor == NULL)
+    {
+        dateIndexCount = 0;
+        dateIndexCapacity = noteSlab.liveCount > 16 ? noteSlab.liveCount : 16;
+        dateIndex = realloc(dateIndex, dateIndexCapacity * sizeof(struct DateIndexEntry));
+        dateIndexCursor = notesList;
+    }
+    for (; dateIndexCursor != NULL && limit > 0; dateIndexCursor = dateIndexCursor->next, limit--)
+    {
+        if (dateIndexCount == dateIndexCapacity)
+        {
+            dateIndexCapacity *= 2;
+            dateIndex = realloc(dateIndex, dateIndexCapacity * sizeof(struct DateIndexEntry));
+        }
+        dateIndex[dateIndexCount].timestamp = dateIndexCursor->note->timestamp;
+        dateIndex[dateIndexCount].id = dateIndexCursor->note->id;
+        dateIndex[dateIndexCount].noteNode = dateIndexCursor;
+        dateIndexCount++;
+    }
+    if (dateIndexCursor == NULL)
+    {
+        qsort(dateIndex, dateIndexCount, sizeof(struct DateIndexEntry), compareDateIndexEntries);
+        dateIndexReady = true;
+    }
+}
+
+void indexNoteDate(struct NoteNode *noteNode)
+{
+    // a change in the middle of an idle build finishes it first
+    if (!dateIndexReady && dateIndexCursor == NULL)
+    {
+        return;
+    }
+    buildDateIndex();
+    if (dateIndexCount == dateIndexCapacity)
+    {
+        dateIndexCapacity *= 2;
+        dateIndex = realloc(dateIndex, dateIndexCapacity * sizeof(struct DateIndexEntry));
+    }
+    int32_t timestamp = noteNode->note->timestamp;
+    size_t position = findDateIndexPosition(timestamp, noteNode->note->id);
+    memmove(&dateIndex[position + 1], &dateIndex[position], (dateIndexCount - position) * sizeof(struct DateIndexEntry));
+    dateIndex[position].timestamp = timestamp;
+    dateIndex[position].id = noteNode->note->id;
+    dateIndex[position].noteNode = noteNode;
+    dateIndexCount++;
+}
+
+void unindexNoteDate(const struct Note *note)
+{
+    // a change in the middle of an idle build finishes it first
+    if (!dateIndexReady && dateIndexCursor == NULL)
+    {
+        return;
+    }
+    buildDateIndex();
+    size_t position = findDateIndexPosition(note->timestamp, note->id);
+    if (position == dateIndexCount || dateIndex[position].id != note->id)
+    {
+        return;
+    }
+    memmove(&dateIndex[position], &dateIndex[position + 1], (dateIndexCount - position - 1) * sizeof(struct DateIndexEntry));
+    dateIndexCount--;
+}
+
+// Words are runs of letters and digits; bytes above 127 count as letters so
+// UTF-8 text is kept whole.
+const char *nextSearchWord(const char *text, size_t *length)
+{
+    while (*text != '\0' && !isalnum((unsigned char)*text) && (unsigned char)*text < 128)
+    {
+        text++;
+    }
+    if (*text == '\0')
+    {
+        return NULL;
+    }
+    const char *end = text;
+    while (*end != '\0' && (isalnum((unsigned char)*end) || (unsigned char)*end >= 128))
+    {
+        end++;
+    }
+    *length = end - text;
+    return text;
+}
+
+// FNV-1a over the lower cased word, so lookups ignore case
+uint64_t hashSearchWord(const char *word, size_t length)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= (unsigned char)tolower((unsigned char)word[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Stored terms are already lower case.
+bool matchesSearchTerm(const struct SearchTerm *term, const char *word)
+{
+    for (size_t i = 0; i < term->length; i++)
+    {
+        if ((unsigned char)term->text[i] != tolower((unsigned char)word[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Terms are never removed, a term whose notes were all deleted just keeps an
+// empty posting list.
+struct SearchTerm *findSearchTerm(const char *word, size_t length, bool create)
+{
+    if (create && (searchTermCount + 1) * 2 > searchTermCapacity)
+    {
+        struct SearchTerm *oldTerms = searchTerms;
+        size_t oldCapacity = searchTermCapacity;
+        searchTermCapacity = oldCapacity == 0 ? 1024 : oldCapacity * 2;
+        searchTerms = calloc(searchTermCapacity, sizeof(struct SearchTerm));
+        for (size_t i = 0; i < oldCapacity; i++)
+        {
+            if (oldTerms[i].text != NULL)
+            {
+                size_t slot = oldTerms[i].hash & (searchTermCapacity - 1);
+                while (searchTerms[slot].text != NULL)
+                {
+                    slot = (slot + 1) & (searchTermCapacity - 1);
+                }
+                searchTerms[slot] = oldTerms[i];
+            }
+        }
+        free(oldTerms);
+    }
+    if (searchTermCapacity == 0)
+    {
+        return NULL;
+    }
+    uint64_t hash = hashSearchWord(word, length);
+    size_t mask = searchTermCapacity - 1;
+    size_t slot = hash & mask;
+    while (searchTerms[slot].text != NULL)
+    {
+        struct SearchTerm *term = &searchTerms[slot];
+        if (term->hash == hash && term->length == length && matchesSearchTerm(term, word))
+        {
+            return term;
+        }
+        slot = (slot + 1) & mask;
+    }
+    if (!create)
+    {
+        return NULL;
+    }
+    struct SearchTerm *term = &searchTerms[slot];
+    term->hash = hash;
+    term->length = length;
+    term->text = arenaAllocate(&searchTermArena, length + 1, 1);
+    for (size_t i = 0; i < length; i++)
+    {
+        term->text[i] = tolower((unsigned char)word[i]);
+    }
+    term->text[length] = '\0';
+    searchTermCount++;
+    return term;
+}
+
+// First posting whose id is not less than the one given.
+size_t findSearchPosting(const struct SearchTerm *term, uint64_t id)
+{
+    size_t low = 0;
+    size_t high = term->postingCount;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (term->postings[middle].id < id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+void addSearchPosting(struct SearchTerm *term, uint64_t id)
+{
+    // notes are mostly indexed in id order, so check the end first
+    size_t position = term->postingCount;
+    if (position > 0 && term->postings[position - 1].id >= id)
+    {
+        position = findSearchPosting(term, id);
+        if (term->postings[position].id == id)
+        {
+            term->postings[position].frequency++;
+            return;
+        }
+    }
+    if (term->postingCount == term->postingCapacity)
+    {
+        term->postingCapacity = term->postingCapacity == 0 ? 4 : term->postingCapacity * 2;
+        term->postings = realloc(term->postings, term->postingCapacity * sizeof(struct SearchPosting));
+    }
+    memmove(&term->postings[position + 1], &term->postings[position], (term->postingCount - position) * sizeof(struct SearchPosting));
+    term->postings[position].id = id;
+    term->postings[position].frequency = 1;
+    term->postingCount++;
+}
+
+void indexNoteText(const struct Note *note)
+{
+    // a change in the middle of an idle build finishes it first
+    if (!searchIndexReady && searchIndexCursor == NULL)
+    {
+        return;
+    }
+    buildSearchIndex();
+    const char *texts[] = {note->title, note->content};
+    for (int i = 0; i < 2; i++)
+    {
+        size_t length;
+        const char *word = texts[i];
+        while ((word = nextSearchWord(word, &length)) != NULL)
+        {
+            addSearchPosting(findSearchTerm(word, length, true), note->id);
+            word += length;
+        }
+    }
+}
+
+void unindexNoteText(const struct Note *note)
+{
+    // a change in the middle of an idle build finishes it first
+    if (!searchIndexReady && searchIndexCursor == NULL)
+    {
+        return;
+    }
+    buildSearchIndex();
+    const char *texts[] = {note->title, note->content};
+    for (int i = 0; i < 2; i++)
+    {
+        size_t length;
+        const char *word = texts[i];
+        while ((word = nextSearchWord(word, &length)) != NULL)
+        {
+            struct SearchTerm *term = findSearchTerm(word, length, false);
+            size_t position = term == NULL ? 0 : findSearchPosting(term, note->id);
+            if (term != NULL && position < term->postingCount && term->postings[position].id == note->id)
+            {
+                term->postingCount--;
+                memmove(&term->postings[position], &term->postings[position + 1], (term->postingCount - position) * sizeof(struct SearchPosting));
+            }
+            word += length;
+        }
+    }
+}
+
+// Built on the first search, then kept up to date as notes change.
+void buildSearchIndex()
+{
+    buildSearchIndexSlice(SIZE_MAX);
+}
+
+// Indexes up to limit more notes, starting where the last call stopped. The
+// index counts as ready while the slice runs so indexNoteText adds to it.
+void buildSearchIndexSlice(size_t limit)
+{
+    if (searchIndexReady)
+    {
+        return;
+    }
+    if (searchIndexCursor == NULL)
+    {
+        searchIndexCursor = notesList;
+    }
+    searchIndexReady = true;
+    for (; searchIndexCursor != NULL && limit > 0; searchIndexCursor = searchIndexCursor->next, limit--)
+    {
+        indexNoteText(searchIndexCursor->note);
+    }
+    searchIndexReady = searchIndexCursor == NULL;
+}
+
+void freeSearchIndex()
+{
+    for (size_t i = 0; i < searchTermCapacity; i++)
+    {
+        free(searchTerms[i].postings);
+    }
+    free(searchTerms);
+    searchTerms = NULL;
+    searchTermCapacity = 0;
+    searchTermCount = 0;
+    freeArena(&searchTermArena);
+    searchIndexReady = false;
+    searchIndexCursor = NULL;
+}
+
+int compareSearchTermsByPostings(const void *first, const void *second)
+{
+    const struct SearchTerm *a = *(struct SearchTerm *const *)first;
+    const struct SearchTerm *b = *(struct SearchTerm *const *)second;
+    return a->postingCount < b->postingCount ? -1 : a->postingCount > b->postingCount;
+}
+
+// Galloping search: first posting at or after start whose id is not less
+// than the one given. Cheap when the answer is close to start.
+size_t skipSearchPostings(const struct SearchTerm *term, size_t start, uint64_t id)
+{
+    size_t step = 1;
+    size_t low = start;
+    size_t high = start;
+    while (high < term->postingCount && term->postings[high].id < id)
+    {
+        low = high + 1;
+        high += step;
+        step *= 2;
+    }
+    if (high > term->postingCount)
+    {
+        high = term->postingCount;
+    }
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (term->postings[middle].id < id)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+// Notes containing every term, sorted by id and scored by the summed term
+// frequency. The shortest list is walked and the others skipped forward.
+size_t intersectSearchTerms(struct SearchTerm **terms, size_t termCount, struct SearchResult **results)
+{
+    qsort(terms, termCount, sizeof(struct SearchTerm *), compareSearchTermsByPostings);
+    *results = malloc((terms[0]->postingCount + 1) * sizeof(struct SearchResult));
+    size_t *positions = calloc(termCount, sizeof(size_t));
+    size_t count = 0;
+    for (size_t i = 0; i < terms[0]->postingCount; i++)
+    {
+        uint64_t id = terms[0]->postings[i].id;
+        uint32_t score = terms[0]->postings[i].frequency;
+        size_t t = 1;
+        for (; t < termCount; t++)
+        {
+            positions[t] = skipSearchPostings(terms[t], positions[t], id);
+            if (positions[t] == terms[t]->postingCount || terms[t]->postings[positions[t]].id != id)
+            {
+                break;
+            }
+            score += terms[t]->postings[positions[t]].frequency;
+        }
+        if (t == termCount)
+        {
+            (*results)[count].id = id;
+            (*results)[count].score = score;
+            count++;
+        }
+    }
+    free(positions);
+    return count;
+}
+
+// Merges two id sorted result lists, adding the scores of notes in both.
+size_t mergeSearchResults(struct SearchResult **results, size_t count, struct SearchResult *other, size_t otherCount)
+{
+    struct SearchResult *merged = malloc((count + otherCount + 1) * sizeof(struct SearchResult));
+    size_t i = 0, j = 0, mergedCount = 0;
+    while (i < count || j < otherCount)
+    {
+        if (j == otherCount || (i < count && (*results)[i].id < other[j].id))
+        {
+            merged[mergedCount++] = (*results)[i++];
+        }
+        else if (i == count || other[j].id < (*results)[i].id)
+        {
+            merged[mergedCount++] = other[j++];
+        }
+        else
+        {
+            merged[mergedCount] = (*results)[i++];
+            merged[mergedCount++].score += other[j++].score;
+        }
+    }
+    free(*results);
+    *results = merged;
+    return mergedCount;
+}
+
+int compareSearchResults(const void *first, const void *second)
+{
+    const struct SearchResult *a = first;
+    const struct SearchResult *b = second;
+    if (a->score != b->score)
+    {
+        return a->score > b->score ? -1 : 1;
+    }
+    return a->id > b->id ? -1 : a->id < b->id;
+}
+
+// Sifts an entry down a heap that keeps the worst ranked result on top.
+void siftSearchResult(struct SearchResult *results, size_t count, size_t parent)
+{
+    while (true)
+    {
+        size_t child = parent * 2 + 1;
+        if (child >= count)
+        {
+            return;
+        }
+        if (child + 1 < count && compareSearchResults(&results[child + 1], &results[child]) > 0)
+        {
+            child++;
+        }
+        if (compareSearchResults(&results[child], &results[parent]) <= 0)
+        {
+            return;
+        }
+        struct SearchResult swap = results[parent];
+        results[parent] = results[child];
+        results[child] = swap;
+        parent = child;
+    }
+}
+
+// Moves the best limit results to the front, in order, without sorting
+// every match.
+void selectBestSearchResults(struct SearchResult *results, size_t count, size_t limit)
+{
+    if (limit > count)
+    {
+        limit = count;
+    }
+    for (size_t i = limit / 2; i-- > 0;)
+    {
+        siftSearchResult(results, limit, i);
+    }
+    for (size_t i = limit; i < count; i++)
+    {
+        if (compareSearchResults(&results[i], &results[0]) < 0)
+        {
+            // swapped rather than overwritten, so every match is kept past limit
+            struct SearchResult swap = results[0];
+            results[0] = results[i];
+            results[i] = swap;
+            siftSearchResult(results, limit, 0);
+        }
+    }
+    qsort(results, limit, sizeof(struct SearchResult), compareSearchResults);
+}
+
+// Words next to each other must all match; OR separates alternatives, so
+// "red apple OR pear" finds notes with both red and apple, or with pear.
+// Returns the number of matches; the best limit of them come first, highest
+// term frequency then newest.
+size_t searchNotes(const char *query, struct SearchResult **results, size_t limit)
+{
+    buildSearchIndex();
+    *results = NULL;
+    size_t resultCount = 0;
+    size_t wordCount = 0;
+    size_t length;
+    for (const char *word = query; (word = nextSearchWord(word, &length)) != NULL; word += length)
+    {
+        wordCount++;
+    }
+    struct SearchTerm **group = malloc((wordCount + 1) * sizeof(struct SearchTerm *));
+    size_t groupCount = 0;
+    bool groupMatches = true;
+    const char *word = query;
+    do
+    {
+        word = nextSearchWord(word, &length);
+        if (word == NULL || (length == 2 && strncmp(word, "OR", 2) == 0))
+        {
+            if (groupMatches && groupCount > 0)
+            {
+                struct SearchResult *groupResults;
+                size_t groupResultCount = intersectSearchTerms(group, groupCount, &groupResults);
+                if (*results == NULL)
+                {
+                    *results = groupResults;
+                    resultCount = groupResultCount;
+                }
+                else
+                {
+                    resultCount = mergeSearchResults(results, resultCount, groupResults, groupResultCount);
+                    free(groupResults);
+                }
+            }
+            groupCount = 0;
+            groupMatches = true;
+        }
+        else if (length != 3 || strncmp(word, "AND", 3) != 0)
+        {
+            struct SearchTerm *term = findSearchTerm(word, length, false);
+            if (term == NULL || term->postingCount == 0)
+            {
+                groupMatches = false;
+            }
+            else
+            {
+                group[groupCount++] = term;
+            }
+        }
+        if (word != NULL)
+        {
+            word += length;
+        }
+    } while (word != NULL);
+    free(group);
+    selectBestSearchResults(*results, resultCount, limit);
+    return resultCount;
+}
+
+bool matchesPattern(const char *text, const char *pattern, size_t length, bool ignoreCase)
+{
+    if (!ignoreCase)
+    {
+        return memcmp(text, pattern, length) == 0;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        if (tolower((unsigned char)text[i]) != tolower((unsigned char)pattern[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char *findPatternScalar(const char *text, const char *end, const char *pattern, size_t length, bool ignoreCase)
+{
+    char first = pattern[0];
+    char firstUpper = ignoreCase ? toupper((unsigned char)first) : first;
+    char firstLower = ignoreCase ? tolower((unsigned char)first) : first;
+    for (; text + length <= end; text++)
+    {
+        if ((*text == firstLower || *text == firstUpper) && matchesPattern(text, pattern, length, ignoreCase))
+        {
+            return text;
+        }
+    }
+    return NULL;
+}
+
+#ifdef GREP_SIMD
+// Compares a block against the first and the last byte of the pattern at
+// once and only checks the whole pattern where both match. With ignoreCase
+// both cases of each byte are accepted.
+GREP_SSE2_TARGET const char *findPatternSse2(const char *text, const char *end, const char *pattern, size_t length, bool ignoreCase)
+{
+    unsigned char first = pattern[0];
+    unsigned char last = pattern[length - 1];
+    __m128i firstLower = _mm_set1_epi8(ignoreCase ? tolower(first) : first);
+    __m128i firstUpper = _mm_set1_epi8(ignoreCase ? toupper(first) : first);
+    __m128i lastLower = _mm_set1_epi8(ignoreCase ? tolower(last) : last);
+    __m128i lastUpper = _mm_set1_epi8(ignoreCase ? toupper(last) : last);
+    for (; text + length - 1 + 16 <= end; text += 16)
+    {
+        __m128i blockFirst = _mm_loadu_si128((const __m128i *)text);
+        __m128i blockLast = _mm_loadu_si128((const __m128i *)(text + length - 1));
+        __m128i matchFirst = _mm_or_si128(_mm_cmpeq_epi8(blockFirst, firstLower), _mm_cmpeq_epi8(blockFirst, firstUpper));
+        __m128i matchLast = _mm_or_si128(_mm_cmpeq_epi8(blockLast, lastLower), _mm_cmpeq_epi8(blockLast, lastUpper));
+        unsigned int mask = _mm_movemask_epi8(_mm_and_si128(matchFirst, matchLast));
+        while (mask != 0)
+        {
+            int bit = __builtin_ctz(mask);
+            if (matchesPattern(text + bit, pattern, length, ignoreCase))
+            {
+                return text + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return findPatternScalar(text, end, pattern, length, ignoreCase);
+}
+
+GREP_AVX2_TARGET const char *findPatternAvx2(const char *text, const char *end, const char *pattern, size_t length, bool ignoreCase)
+{
+    unsigned char first = pattern[0];
+    unsigned char last = pattern[length - 1];
+    __m256i firstLower = _mm256_set1_epi8(ignoreCase ? tolower(first) : first);
+    __m256i firstUpper = _mm256_set1_epi8(ignoreCase ? toupper(first) : first);
+    __m256i lastLower = _mm256_set1_epi8(ignoreCase ? tolower(last) : last);
+    __m256i lastUpper = _mm256_set1_epi8(ignoreCase ? toupper(last) : last);
+    for (; text + length - 1 + 32 <= end; text += 32)
+    {
+        __m256i blockFirst = _mm256_loadu_si256((const __m256i *)text);
+        __m256i blockLast = _mm256_loadu_si256((const __m256i *)(text + length - 1));
+        __m256i matchFirst = _mm256_or_si256(_mm256_cmpeq_epi8(blockFirst, firstLower), _mm256_cmpeq_epi8(blockFirst, firstUpper));
+        __m256i matchLast = _mm256_or_si256(_mm256_cmpeq_epi8(blockLast, lastLower), _mm256_cmpeq_epi8(blockLast, lastUpper));
+        unsigned int mask = _mm256_movemask_epi8(_mm256_and_si256(matchFirst, matchLast));
+        while (mask != 0)
+        {
+            int bit = __builtin_ctz(mask);
+            if (matchesPattern(text + bit, pattern, length, ignoreCase))
+            {
+                return text + bit;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return findPatternSse2(text, end, pattern, length, ignoreCase);
+}
+#endif
+
+// First occurrence of pattern in [text, end), or NULL.
+const char *findPattern(const char *text, const char *end, const char *pattern, size_t length, bool ignoreCase)
+{
+#ifdef GREP_SIMD
+    static int simdLevel = -1;
+    if (simdLevel < 0)
+    {
+        __builtin_cpu_init();
+        simdLevel = __builtin_cpu_supports("avx2") ? 2 : __builtin_cpu_supports("sse2") ? 1 : 0;
+    }
+    if (simdLevel == 2)
+    {
+        return findPatternAvx2(text, end, pattern, length, ignoreCase);
+    }
+    if (simdLevel == 1)
+    {
+        return findPatternSse2(text, end, pattern, length, ignoreCase);
+    }
+#endif
+    return findPatternScalar(text, end, pattern, length, ignoreCase);
+}
+
+int compareGrepSpans(const void *first, const void *second)
+{
+    const struct GrepSpan *a = first;
+    const struct GrepSpan *b = second;
+    return a->text < b->text ? -1 : a->text > b->text;
+}
+
+int compareNoteIds(const void *first, const void *second)
+{
+    uint64_t a = *(const uint64_t *)first;
+    uint64_t b = *(const uint64_t *)second;
+    return a < b ? -1 : a > b;
+}
+
+// Live strings sorted by address. Notes read from notes.bin keep their titles
+// and contents back to back in the mapped file, so most of them end up in two
+// long runs.
+void buildGrepSpans()
+{
+    if (grepSpansReady)
+    {
+        return;
+    }
+    size_t count = noteSlab.liveCount * 2;
+    if (count > grepSpanCapacity)
+    {
+        free(grepSpans);
+        grepSpans = malloc(count * sizeof(struct GrepSpan));
+        grepSpanCapacity = count;
+    }
+    grepSpanCount = 0;
+    for (int field = 0; field < 2; field++)
+    {
+        for (struct NoteNode *noteNode = notesList; noteNode != NULL; noteNode = noteNode->next)
+        {
+            struct GrepSpan *span = &grepSpans[grepSpanCount++];
+            span->text = field == 0 ? noteNode->note->title : noteNode->note->content;
+            span->length = strlen(span->text);
+            span->note = noteNode->note;
+        }
+    }
+    size_t i = 1;
+    while (i < grepSpanCount && grepSpans[i - 1].text < grepSpans[i].text)
+    {
+        i++;
+    }
+    if (i < grepSpanCount)
+    {
+        qsort(grepSpans, grepSpanCount, sizeof(struct GrepSpan), compareGrepSpans);
+    }
+    grepSpansReady = true;
+}
+
+// Ids of the notes whose title or content contains pattern, in ascending
+// order. Runs of adjacent strings are scanned as one block; a pattern has no
+// NUL so a hit never crosses from one string into the next.
+size_t grepNotes(const char *pattern, bool ignoreCase, uint64_t **ids)
+{
+    buildGrepSpans();
+    size_t length = strlen(pattern);
+    size_t count = 0;
+    *ids = malloc((grepSpanCount + 1) * sizeof(uint64_t));
+    size_t runStart = 0;
+    while (runStart < grepSpanCount)
+    {
+        size_t runEnd = runStart + 1;
+        while (runEnd < grepSpanCount && grepSpans[runEnd].text == grepSpans[runEnd - 1].text + grepSpans[runEnd - 1].length + 1)
+        {
+            runEnd++;
+        }
+        const char *text = grepSpans[runStart].text;
+        const char *end = grepSpans[runEnd - 1].text + grepSpans[runEnd - 1].length;
+        size_t span = runStart;
+        while ((text = findPattern(text, end, pattern, length, ignoreCase)) != NULL)
+        {
+            while (span + 1 < runEnd && grepSpans[span + 1].text <= text)
+            {
+                span++;
+            }
+            (*ids)[count++] = grepSpans[span].note->id;
+            text = grepSpans[span].text + grepSpans[span].length;
+        }
+        runStart = runEnd;
+    }
+    // a note matching in both its title and its content is listed once
+    qsort(*ids, count, sizeof(uint64_t), compareNoteIds);
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (unique == 0 || (*ids)[unique - 1] != (*ids)[i])
+        {
+            (*ids)[unique++] = (*ids)[i];
+        }
+    }
+    return unique;
+}
+
+int compareTrigrams(const void *first, const void *second)
+{
+    uint32_t a = *(const uint32_t *)first;
+    uint32_t b = *(const uint32_t *)second;
+    return a < b ? -1 : a > b;
+}
+
+// Distinct trigrams of the lower cased title, which is padded with two
+// spaces in front and one behind so short titles and word starts count.
+// Anything other than letters and digits is treated as a space.
+size_t getTitleTrigrams(const char *title, uint32_t *trigrams)
+{
+    size_t count = 0;
+    uint32_t window = ((uint32_t)' ' << 8) | ' ';
+    for (const char *c = title;; c++)
+    {
+        unsigned char next = *c == '\0' ? ' ' : (unsigned char)*c;
+        if (!isalnum(next) && next < 128)
+        {
+            next = ' ';
+        }
+        next = tolower(next);
+        // runs of separators collapse into one space
+        if (next != ' ' || (window & 0xff) != ' ')
+        {
+            window = ((window << 8) | next) & 0xffffff;
+            if (window != (((uint32_t)' ' << 16) | ((uint32_t)' ' << 8) | ' ') && count < TITLE_TRIGRAM_LIMIT)
+            {
+                trigrams[count++] = window;
+            }
+        }
+        if (*c == '\0')
+        {
+            break;
+        }
+    }
+    qsort(trigrams, count, sizeof(uint32_t), compareTrigrams);
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (unique == 0 || trigrams[unique - 1] != trigrams[i])
+        {
+            trigrams[unique++] = trigrams[i];
+        }
+    }
+    return unique;
+}
+
+struct TrigramEntry *findTrigramEntry(uint32_t trigram, bool create)
+{
+    if (create && (trigramEntryCount + 1) * 2 > trigramEntryCapacity)
+    {
+        struct TrigramEntry *oldEntries = trigramEntries;
+        size_t oldCapacity = trigramEntryCapacity;
+        trigramEntryCapacity = oldCapacity == 0 ? 4096 : oldCapacity * 2;
+        trigramEntries = calloc(trigramEntryCapacity, sizeof(struct TrigramEntry));
+        for (size_t i = 0; i < oldCapacity; i++)
+        {
+            if (oldEntries[i].trigram != 0)
+            {
+                size_t slot = hashNoteKey(oldEntries[i].trigram) & (trigramEntryCapacity - 1);
+                while (trigramEntries[slot].trigram != 0)
+                {
+                    slot = (slot + 1) & (trigramEntryCapacity - 1);
+                }
+                trigramEntries[slot] = oldEntries[i];
+            }
+        }
+        free(oldEntries);
+    }
+    if (trigramEntryCapacity == 0)
+    {
+        return NULL;
+    }
+    size_t mask = trigramEntryCapacity - 1;
+    size_t slot = hashNoteKey(trigram) & mask;
+    while (trigramEntries[slot].trigram != 0)
+    {
+        if (trigramEntries[slot].trigram == trigram)
+        {
+            return &trigramEntries[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    if (!create)
+    {
+        return NULL;
+    }
+    trigramEntries[slot].trigram = trigram;
+    trigramEntryCount++;
+    return &trigramEntries[slot];
+}
+
+void indexNoteTitle(struct Note *note)
+{
+    // a change in the middle of an idle build finishes it first
+    if (!trigramIndexReady && trigramIndexCursor == NULL)
+    {
+        return;
+    }
+    buildTrigramIndex();
+    if (trigramSlotCount == trigramSlotCapacity)
+    {
+        trigramSlotCapacity = trigramSlotCapacity == 0 ? 1024 : trigramSlotCapacity * 2;
+        trigramNotes = realloc(trigramNotes, trigramSlotCapacity * sizeof(struct Note *));
+        trigramCounts = realloc(trigramCounts, trigramSlotCapacity * sizeof(uint8_t));
+        trigramShared = realloc(trigramShared, trigramSlotCapacity * sizeof(uint16_t));
+    }
+    uint32_t slot = trigramSlotCount++;
+    uint32_t trigrams[TITLE_TRIGRAM_LIMIT];
+    size_t count = getTitleTrigrams(note->title, trigrams);
+    for (size_t i = 0; i < count; i++)
+    {
+        struct TrigramEntry *entry = findTrigramEntry(trigrams[i], true);
+        if (entry->postingCount == entry->postingCapacity)
+        {
+            entry->postingCapacity = entry->postingCapacity == 0 ? 4 : entry->postingCapacity * 2;
+            entry->postings = realloc(entry->postings, entry->postingCapacity * sizeof(uint32_t));
+        }
+        entry->postings[entry->postingCount++] = slot;
+    }
+    trigramNotes[slot] = note;
+    trigramCounts[slot] = count;
+    trigramShared[slot] = 0;
+    note->trigramSlot = slot;
+}
+
+void unindexNoteTitle(const struct Note *note)
+{
+    // a change in the middle of an idle build finishes it first
+    if (!trigramIndexReady && trigramIndexCursor == NULL)
+    {
+        return;
+    }
+    buildTrigramIndex();
+    uint32_t slot = note->trigramSlot;
+    uint32_t trigrams[TITLE_TRIGRAM_LIMIT];
+    size_t count = getTitleTrigrams(note->title, trigrams);
+    for (size_t i = 0; i < count; i++)
+    {
+        struct TrigramEntry *entry = findTrigramEntry(trigrams[i], false);
+        if (entry == NULL)
+        {
+            continue;
+        }
+        size_t low = 0;
+        size_t high = entry->postingCount;
+        while (low < high)
+        {
+            size_t middle = low + (high - low) / 2;
+            if (entry->postings[middle] < slot)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        if (low < entry->postingCount && entry->postings[low] == slot)
+        {
+            entry->postingCount--;
+            memmove(&entry->postings[low], &entry->postings[low + 1], (entry->postingCount - low) * sizeof(uint32_t));
+        }
+    }
+    trigramNotes[slot] = NULL;
+}
+
+// Built the first time a picker is narrowed, then kept up to date.
+void buildTrigramIndex()
+{
+    buildTrigramIndexSlice(SIZE_MAX);
+}
+
+// Indexes up to limit more titles, starting where the last call stopped.
+void buildTrigramIndexSlice(size_t limit)
+{
+    if (trigramIndexReady)
+    {
+        return;
+    }
+    if (trigramIndexCursor == NULL)
+    {
+        trigramIndexCursor = notesList;
+    }
+    trigramIndexReady = true;
+    for (; trigramIndexCursor != NULL && limit > 0; trigramIndexCursor = trigramIndexCursor->next, limit--)
+    {
+        indexNoteTitle(trigramIndexCursor->note);
+    }
+    trigramIndexReady = trigramIndexCursor == NULL;
+}
+
+void freeTrigramIndex()
+{
+    for (size_t i = 0; i < trigramEntryCapacity; i++)
+    {
+        free(trigramEntries[i].postings);
+    }
+    free(trigramEntries);
+    free(trigramNotes);
+    free(trigramCounts);
+    free(trigramShared);
+    trigramEntries = NULL;
+    trigramNotes = NULL;
+    trigramCounts = NULL;
+    trigramShared = NULL;
+    trigramEntryCapacity = 0;
+    trigramEntryCount = 0;
+    trigramSlotCount = 0;
+    trigramSlotCapacity = 0;
+    trigramIndexReady = false;
+    trigramIndexCursor = NULL;
+}
+
+// Fills matches with up to limit titles most similar to query, best first.
+// Similarity is shared trigrams over all distinct trigrams of both, so a
+// typo only costs the few trigrams around it.
+size_t findFuzzyTitles(const char *query, struct FuzzyMatch *matches, size_t limit)
+{
+    buildTrigramIndex();
+    uint32_t trigrams[TITLE_TRIGRAM_LIMIT];
+    size_t queryCount = getTitleTrigrams(query, trigrams);
+    struct TrigramEntry *entries[TITLE_TRIGRAM_LIMIT];
+    size_t entryCount = 0;
+    for (size_t i = 0; i < queryCount; i++)
+    {
+        struct TrigramEntry *entry = findTrigramEntry(trigrams[i], false);
+        if (entry != NULL)
+        {
+            entries[entryCount++] = entry;
+        }
+    }
+    for (size_t i = 0; i < entryCount; i++)
+    {
+        for (uint32_t p = 0; p < entries[i]->postingCount; p++)
+        {
+            trigramShared[entries[i]->postings[p]]++;
+        }
+    }
+    // the second pass scores each slot once and clears it for the next query
+    size_t matchCount = 0;
+    for (size_t i = 0; i < entryCount; i++)
+    {
+        for (uint32_t p = 0; p < entries[i]->postingCount; p++)
+        {
+            uint32_t slot = entries[i]->postings[p];
+            uint16_t shared = trigramShared[slot];
+            if (shared == 0)
+            {
+                continue;
+            }
+            trigramShared[slot] = 0;
+            double similarity = (double)shared / (queryCount + trigramCounts[slot] - shared);
+            if (matchCount == limit && similarity <= matches[limit - 1].similarity)
+            {
+                continue;
+            }
+            size_t position = matchCount < limit ? matchCount++ : limit - 1;
+            while (position > 0 && matches[position - 1].similarity < similarity)
+            {
+                matches[position] = matches[position - 1];
+                position--;
+            }
+            matches[position].note = trigramNotes[slot];
+            matches[position].similarity = similarity;
+        }
+    }
+    return matchCount;
+}
+
+void removeNoteFromList(uint64_t key)
+{
+    struct NoteNode *noteNode = findNoteNode(key);
+    if (noteNode == NULL)
+    {
+        return;
+    }
+    unindexNoteKey(key);
+    unindexNoteDate(noteNode->note);
+    unindexNoteText(noteNode->note);
+    unindexNoteTitle(noteNode->note);
+    grepSpansReady = false;
+    if (noteNode->previous == NULL)
+    {
+        notesList = noteNode->next;
+    }
+    else
+    {
+        noteNode->previous->next = noteNode->next;
+    }
+    if (noteNode->next == NULL)
+    {
+        notesListTail = noteNode->previous;
+    }
+    else
+    {
+        noteNode->next->previous = noteNode->previous;
+    }
+    if (noteNode->note->menuItem != NULL)
+    {
+        slabFree(&menuItemSlab, noteNode->note->menuItem);
+    }
+    slabFree(&noteSlab, noteNode->note);
+    slabFree(&noteNodeSlab, noteNode);
+}
+
+void replaceNote(struct Note *note)
+{
+    struct NoteNode *noteNode = findNoteNode(note->id);
+    if (noteNode == NULL)
+    {
+        addNoteToList(note);
+        return;
+    }
+    unindexNoteText(noteNode->note);
+    unindexNoteTitle(noteNode->note);
+    noteNode->note->title = note->title;
+    noteNode->note->content = note->content;
+    indexNoteText(noteNode->note);
+    indexNoteTitle(noteNode->note);
+    grepSpansReady = false;
+    unindexNoteDate(noteNode->note);
+    noteNode->note->timestamp = note->timestamp;
+    indexNoteDate(noteNode);
+    updateNoteMenuTitle(noteNode->note);
+    slabFree(&noteSlab, note);
+}
+
+// Returns false when the deletion could not be journaled; the note is then
+// kept.
+bool deleteNote(const char *key)
+{
+    struct NoteNode *noteNode = findNoteNode(parseNoteKey(key));
+    if (noteNode == NULL)
+    {
+        return true;
+    }
+    if (!appendJournalRecord('D', noteNode->note))
+    {
+        return false;
+    }
+    removeNoteFromList(noteNode->note->id);
+    compactNotesIfNeeded();
+    return true;
+}
+
+void deletePickedNote(void *key)
+{
+    if (!deleteNote(key))
+    {
+        clearScreen();
+        printf("%s\n", getTranslation("noteSaveFailed"));
+        pauseScreen();
+    }
+}
+
+// IDs are the creation time in seconds shifted past a 20 bit sequence number
+// and never go below the newest ID already loaded, so they stay unique and
+// increasing across restarts without scanning the notes.
+uint64_t generateId()
+{
+    uint64_t id = (uint64_t)time(NULL) << 20;
+    if (id <= lastNoteId)
+    {
+        id = lastNoteId + 1;
+    }
+    lastNoteId = id;
+    return id;
+}
+
+// Hands out count consecutive ids at once, the first one as generateId()
+// would.
+uint64_t reserveNoteIds(size_t count)
+{
+    uint64_t first = generateId();
+    lastNoteId = first + count - 1;
+    return first;
+}
+
+void *getInput(const char *message, const char *(validator)(void *), bool canBeEmpty)
+{
+    void *input = NULL;
+    char buffer[256];
+    printf("%s\n", message);
+    presentScreen();
+    readLine(buffer, sizeof(buffer));
+    input = (void *)malloc(strlen(buffer) + 1);
+    strcpy(input, buffer);
+    if (canBeEmpty && strlen(buffer) == 0)
+    {
+        return NULL;
+    }
+    while (validator(input) != NULL)
+    {
+
+        clearScreen();
+        printf("%s\n", getTranslation("invalidInput"));
+        printf("%s", validator(input));
+        printf("%s\n", message);
+        presentScreen();
+        readLine(buffer, sizeof(buffer));
+        input = realloc(input, strlen(buffer) + 1);
+        strcpy(input, buffer);
+    }
+    return input;
+}
+
+// Writes the info block of a note, ending with the separator line.
+void formatNoteSummary(struct TextBuffer *output, const struct Note *note, bool withContent)
+{
+    char date[11];
+    char time[6];
+    formatDate(note->timestamp, date);
+    formatTime(note->timestamp, time);
+    const char *values[TEMPLATE_FIELD_COUNT] = {NULL};
+    values[TEMPLATE_TITLE] = note->title;
+    values[TEMPLATE_CONTENT] = note->content;
+    values[TEMPLATE_DATE] = date;
+    values[TEMPLATE_TIME] = time;
+    appendText(output, "-", 1);
+    renderTemplate(output, getMessageTemplate("noteInfo"), values);
+    appendText(output, "\n      -", 8);
+    renderTemplate(output, getMessageTemplate("title"), values);
+    appendText(output, "\n      -", 8);
+    renderTemplate(output, getMessageTemplate("dateInfo"), values);
+    appendText(output, "\n         -", 11);
+    renderTemplate(output, getMessageTemplate("date"), values);
+    appendText(output, "\n         -", 11);
+    renderTemplate(output, getMessageTemplate("time"), values);
+    if (withContent)
+    {
+        appendText(output, "\n      -", 8);
+        renderTemplate(output, getMessageTemplate("content"), values);
+    }
+    appendText(output, "\n" NOTE_SEPARATOR, strlen(NOTE_SEPARATOR) + 1);
+}
+
+void printNoteSummary(const struct Note *note)
+{
+    char text[MESSAGE_BUFFER_SIZE];
+    struct TextBuffer output = {text, sizeof(text), 0};
+    formatNoteSummary(&output, note, false);
+    fputs(text, stdout);
+}
+
+// Prints the notes dated in [from, to) in chronological order.
+void printNotesInDateRange(int32_t from, int32_t to)
+{
+    buildDateIndex();
+    size_t start = findDateIndexPosition(from, 0);
+    size_t end = findDateIndexPosition(to, 0);
+    if (start == end)
+    {
+        printf("%s\n", getTranslation("noNotesFound"));
+        return;
+    }
+    fputs(NOTE_SEPARATOR, stdout);
+    for (size_t position = start; position < end; position++)
+    {
+        printNoteSummary(dateIndex[position].noteNode->note);
+    }
+}
+
+void viewNotesByDate()
+{
+    clearScreen();
+    char *input = getInput(getTranslation("getInputDate"), dateBoundValidator, false);
+    int32_t timestamp = parseDate(input);
+    free(input);
+    clearScreen();
+    int32_t dayStart = timestamp - timestamp % MINUTES_PER_DAY;
+    if (timestamp % MINUTES_PER_DAY < 0)
+    {
+        dayStart -= MINUTES_PER_DAY;
+    }
+    printNotesInDateRange(dayStart, dayStart + MINUTES_PER_DAY);
+    pauseScreen();
+}
+
+void viewNotesByDateRange()
+{
+    clearScreen();
+    char *input = getInput(getTranslation("getInputStartDate"), dateBoundValidator, false);
+    int32_t from = parseDate(input);
+    free(input);
+    clearScreen();
+    input = getInput(getTranslation("getInputEndDate"), dateBoundValidator, false);
+    int32_t to = parseDate(input);
+    free(input);
+    clearScreen();
+    if (from > to)
+    {
+        int32_t swap = from;
+        from = to;
+        to = swap;
+    }
+    printNotesInDateRange(from, to + 1);
+    pauseScreen();
+}
+
+void viewLatestNotes()
+{
+    clearScreen();
+    buildDateIndex();
+    if (dateIndexCount == 0)
+    {
+        printf("%s\n", getTranslation("noNotesFound"));
+        pauseScreen();
+        return;
+    }
+    fputs(NOTE_SEPARATOR, stdout);
+    size_t shown = dateIndexCount < LATEST_NOTES_COUNT ? dateIndexCount : LATEST_NOTES_COUNT;
+    for (size_t i = 1; i <= shown; i++)
+    {
+        printNoteSummary(dateIndex[dateIndexCount - i].noteNode->note);
+    }
+    pauseScreen();
+}
+
+void searchNotesAction()
+{
+    clearScreen();
+    char *query = getInput(getTranslation("getInputSearchQuery"), searchQueryValidator, false);
+    struct SearchResult *results;
+    size_t resultCount = searchNotes(query, &results, SEARCH_RESULTS_LIMIT);
+    free(query);
+    clearScreen();
+    if (resultCount == 0)
+    {
+        printf("%s\n", getTranslation("noNotesFound"));
+        free(results);
+        pauseScreen();
+        return;
+    }
+    char count[21];
+    sprintf(count, "%zu", resultCount);
+    const char *values[TEMPLATE_FIELD_COUNT] = {NULL};
+    values[TEMPLATE_COUNT] = count;
+    printMessage("searchResultsCount", values);
+    fputs(NOTE_SEPARATOR, stdout);
+    size_t shown = resultCount < SEARCH_RESULTS_LIMIT ? resultCount : SEARCH_RESULTS_LIMIT;
+    for (size_t i = 0; i < shown; i++)
+    {
+        printNoteSummary(findNoteNode(results[i].id)->note);
+    }
+    free(results);
+    pauseScreen();
+}
+
+void runGrep(bool ignoreCase)
+{
+    clearScreen();
+    char *pattern = getInput(getTranslation("getInputGrepPattern"), grepPatternValidator, false);
+    uint64_t *ids;
+    size_t count = grepNotes(pattern, ignoreCase, &ids);
+    free(pattern);
+    clearScreen();
+    if (count == 0)
+    {
+        printf("%s\n", getTranslation("noNotesFound"));
+        free(ids);
+        pauseScreen();
+        return;
+    }
+    char countText[21];
+    sprintf(countText, "%zu", count);
+    const char *values[TEMPLATE_FIELD_COUNT] = {NULL};
+    values[TEMPLATE_COUNT] = countText;
+    printMessage("searchResultsCount", values);
+    fputs(NOTE_SEPARATOR, stdout);
+    size_t shown = count < SEARCH_RESULTS_LIMIT ? count : SEARCH_RESULTS_LIMIT;
+    for (size_t i = 0; i < shown; i++)
+    {
+        printNoteSummary(findNoteNode(ids[i])->note);
+    }
+    free(ids);
+    pauseScreen();
+}
+
+void grepMatchCase(void *_)
+{
+    (void)_;
+    runGrep(false);
+}
+
+void grepIgnoreCase(void *_)
+{
+    (void)_;
+    runGrep(true);
+}
+
+void grepNotesAction()
+{
+    struct MenuItem **menuItem = malloc(sizeof(struct MenuItem *) * 3);
+    menuItem[0] = malloc(sizeof(struct MenuItem));
+    menuItem[0]->key = "grepMatchCase";
+    menuItem[0]->title = NULL;
+    menuItem[0]->action = grepMatchCase;
+    menuItem[0]->getTranslation = true;
+    menuItem[1] = malloc(sizeof(struct MenuItem));
+    menuItem[1]->key = "grepIgnoreCase";
+    menuItem[1]->title = NULL;
+    menuItem[1]->action = grepIgnoreCase;
+    menuItem[1]->getTranslation = true;
+    menuItem[2] = NULL;
+    showMenu(menuItem, "grepNotesAction", "grepNotesIndication");
+    free(menuItem[0]);
+    free(menuItem[1]);
+    free(menuItem);
+}
+
+void viewNotes()
+{
+    if (notesList == NULL)
+    {
+        clearScreen();
+        printf("%s\n", getTranslation("noNotesFound"));
+        pauseScreen();
+        return;
+    }
+    showNoteList(NULL, "viewNotes", "viewNotesIndication", true, false);
+}
+
+static const char digitPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// Writes dd.mm.yyyy into date, which must hold 11 bytes.
+void formatDate(int32_t timestamp, char *date)
+{
+    struct Date fields;
+    splitTimestamp(timestamp, &fields);
+    memcpy(date, &digitPairs[fields.day * 2], 2);
+    date[2] = '.';
+    memcpy(date + 3, &digitPairs[fields.month * 2], 2);
+    date[5] = '.';
+    memcpy(date + 6, &digitPairs[(fields.year / 100 % 100) * 2], 2);
+    memcpy(date + 8, &digitPairs[(fields.year % 100) * 2], 2);
+    date[10] = '\0';
+}
+
+// Writes hh:mm into time, which must hold 6 bytes.
+void formatTime(int32_t timestamp, char *time)
+{
+    struct Date fields;
+    splitTimestamp(timestamp, &fields);
+    memcpy(time, &digitPairs[fields.hour * 2], 2);
+    time[2] = ':';
+    memcpy(time + 3, &digitPairs[fields.minute * 2], 2);
+    time[5] = '\0';
+}
+
+void changeColorAction()
+{
+    struct MenuItem **menuItems = malloc(sizeof(struct MenuItem *) * 7);
+
+    struct MenuItem *redMenuItem = malloc(sizeof(struct MenuItem));
+    redMenuItem->title = NULL;
+    redMenuItem->key = malloc(sizeof(char) * 3);
+    redMenuItem->getTranslation = true;
+    sprintf(redMenuItem->key, "%d", RED);
+    redMenuItem->action = changeColor;
+    menuItems[0] = redMenuItem;
+
+    struct MenuItem *greenMenuItem = malloc(sizeof(struct MenuItem));
+    greenMenuItem->title = NULL;
+    greenMenuItem->key = malloc(sizeof(char) * 3);
+    greenMenuItem->getTranslation = true;
+    sprintf(greenMenuItem->key, "%d", GREEN);
+    greenMenuItem->action = changeColor;
+    menuItems[1] = greenMenuItem;
+
+    struct MenuItem *blueMenuItem = malloc(sizeof(struct MenuItem));
+    blueMenuItem->title = NULL;
+    blueMenuItem->key = malloc(sizeof(char) * 3);
+    blueMenuItem->getTranslation = true;
+    sprintf(blueMenuItem->key, "%d", BLUE);
+    blueMenuItem->action = changeColor;
+    menuItems[2] = blueMenuItem;
+
+    struct MenuItem *yellowMenuItem = malloc(sizeof(struct MenuItem));
+    yellowMenuItem->title = NULL;
+    yellowMenuItem->key = malloc(sizeof(char) * 3);
+    yellowMenuItem->getTranslation = true;
+    sprintf(yellowMenuItem->key, "%d", YELLOW);
+    yellowMenuItem->action = changeColor;
+    menuItems[3] = yellowMenuItem;
+
+    struct MenuItem *whiteMenuItem = malloc(sizeof(struct MenuItem));
+    whiteMenuItem->title = NULL;
+    whiteMenuItem->key = malloc(sizeof(char) * 2);
+    whiteMenuItem->getTranslation = true;
+    sprintf(whiteMenuItem->key, "%d", WHITE);
+    whiteMenuItem->action = changeColor;
+    menuItems[4] = whiteMenuItem;
+
+    struct MenuItem *backMenuItem = malloc(sizeof(struct MenuItem));
+    backMenuItem->title = NULL;
+    backMenuItem->key = "back";
+    backMenuItem->getTranslation = true;
+    backMenuItem->action = back;
+    menuItems[5] = backMenuItem;
+
+    menuItems[6] = NULL;
+
+    showMenu(menuItems, "changeColorActionTitle", "changeColorActionIndication");
+}
+
+void changeLanguageAction()
+{
+    struct MenuItem **menuItems = malloc(sizeof(struct MenuItem *) * (translationLanguageCount + 2));
+    for (int i = 0; i < translationLanguageCount; i++)
+    {
+        struct MenuItem *languageMenuItem = malloc(sizeof(struct MenuItem));
+        languageMenuItem->title = "Language";
+        char* key = malloc(sizeof(char) * 12);
+        sprintf(key, "%d", i);
+        languageMenuItem->key = key;
+        languageMenuItem->action = changeLanguage;
+        languageMenuItem->getTranslation = true;
+        menuItems[i] = languageMenuItem;
+    }
+    struct MenuItem *backMenuItem = malloc(sizeof(struct MenuItem));
+    backMenuItem->title = NULL;
+    backMenuItem->key = "back";
+    backMenuItem->action = back;
+    backMenuItem->getTranslation = true;
+    menuItems[translationLanguageCount] = backMenuItem;
+    menuItems[translationLanguageCount + 1] = NULL;
+
+    showMenu(menuItems, "changeLanguageActionTitle", "changeLanguageActionIndication");
+}
+
+
+void changeColor(void *color)
+{
+    config->color = atoi(color);
+    setScreenColor(config->color);
+    saveConfig();
+    clearScreen();
+    printf("%s\n", getTranslation("colorChangedSuccessfully"));
+    pauseScreen();
+}
+
+// Every language is already loaded, switching only picks another column.
+void changeLanguage(void *language)
+{
+    config->language = atoi(language);
+    if (config->language < 0 || config->language >= translationLanguageCount)
+    {
+        config->language = ENGLISH;
+    }
+    saveConfig();
+}
+
+void settingsAction()
+{
+    struct MenuItem **menuItems = malloc(sizeof(struct MenuItem *) * 6);
+    struct MenuItem *changeColor = malloc(sizeof(struct MenuItem));
+    changeColor->title = NULL;
+    changeColor->key = "changeColorActionTitle";
+    changeColor->action = changeColorAction;
+    changeColor->getTranslation = true;
+    menuItems[0] = changeColor;
+
+    struct MenuItem *changeLanguage = malloc(sizeof(struct MenuItem));
+    changeLanguage->title = NULL;
+    changeLanguage->key = "changeLanguageActionTitle";
+    changeLanguage->action = changeLanguageAction;
+    changeLanguage->getTranslation = true;
+    menuItems[1] = changeLanguage;
+
+    struct MenuItem *exportNotes = malloc(sizeof(struct MenuItem));
+    exportNotes->title = NULL;
+    exportNotes->key = "exportNotesAction";
+    exportNotes->action = exportNotesAction;
+    exportNotes->getTranslation = true;
+    menuItems[2] = exportNotes;
+
+    struct MenuItem *memoryStats = malloc(sizeof(struct MenuItem));
+    memoryStats->title = NULL;
+    memoryStats->key = "memoryStatsAction";
+    memoryStats->action = memoryStatsAction;
+    memoryStats->getTranslation = true;
+    menuItems[3] = memoryStats;
+
+    struct MenuItem *backMenuItem = malloc(sizeof(struct MenuItem));
+    backMenuItem->title = NULL;
+    backMenuItem->key = "back";
+    backMenuItem->action = back;
+    backMenuItem->getTranslation = true;
+    menuItems[4] = backMenuItem;
+
+    menuItems[5] = NULL;
+
+    showMenu(menuItems, "settingsActionTitle", "settingActionIndication");
+}
+
+// Lists notes for the edit and delete menus. Typing after / ranks the
+// closest titles again on every key, so a typo still finds the note.
+void showNotePicker(void (*action)(void *), char *titleTranslationKey)
+{
+    if (notesList == NULL)
+    {
+        clearScreen();
+        printf("%s\n", getTranslation("noNotesFound"));
+        pauseScreen();
+        return;
+    }
+    showNoteList(action, titleTranslationKey, "noteListIndication", false, true);
+}
+
+void editNoteAction()
+{
+    showNotePicker(editNote, "editNoteActionTitle");
+}
+
+void deleteNoteAction()
+{
+    showNotePicker(deletePickedNote, "deleteNoteActionTitle");
+}
+
+bool stayInMenu(char *key)
+{
+    return strstr(key, "Action") != NULL;
+    // modified without testing
+    // TODO: test
+}
+
+// Screens are drawn into the stdout buffer and only reach the terminal when
+// the app waits for input, so a whole frame goes out in a single write.
+void initScreen()
+{
+#ifdef _WIN32
+    HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode;
+    if (GetConsoleMode(console, &mode))
+    {
+        SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+    }
+#endif
+    setvbuf(stdout, screenBuffer, _IOFBF, sizeof(screenBuffer));
+}
+
+void clearScreen()
+{
+    fputs("\033[H\033[2J\033[3J", stdout);
+}
+
+void presentScreen()
+{
+    fflush(stdout);
+}
+
+// Colors are stored as console attributes (blue, green and red bits plus
+// intensity); ANSI numbers the same colors red, green, blue.
+void setScreenColor(int color)
+{
+    static const int ansiColors[8] = {0, 4, 2, 6, 1, 5, 3, 7};
+    printf("\033[0;%dm", ((color & 8) ? 90 : 30) + ansiColors[color & 7]);
+}
+
+// Keys are read one at a time without echo while a menu waits; typed lines
+// go back to the terminal's own line editing.
+void setRawMode(bool enabled)
+{
+#ifndef _WIN32
+    if (enabled == rawMode || !isatty(STDIN_FILENO))
+    {
+        return;
+    }
+    if (enabled)
+    {
+        tcgetattr(STDIN_FILENO, &savedTerminal);
+        struct termios raw = savedTerminal;
+        raw.c_lflag &= ~(ICANON | ECHO | ISIG);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    }
+    else
+    {
+        tcsetattr(STDIN_FILENO, TCSANOW, &savedTerminal);
+    }
+    rawMode = enabled;
+#endif
+}
+
+// Returns true once input is available, or false when timeout milliseconds
+// pass first. A negative timeout waits for as long as it takes.
+bool waitForInput(int timeout)
+{
+#ifdef _WIN32
+    for (int waited = 0; !_kbhit(); waited += 10)
+    {
+        if (timeout >= 0 && waited >= timeout)
+        {
+            return false;
+        }
+        Sleep(10);
+    }
+    return true;
+#else
+    if (inputStart < inputEnd)
+    {
+        return true;
+    }
+    struct pollfd input = {STDIN_FILENO, POLLIN, 0};
+    return poll(&input, 1, timeout) > 0;
+#endif
+}
+
+// Keys and lines share one buffer, so a line typed ahead of a prompt is
+// never lost between the two.
+int readInputByte()
+{
+#ifdef _WIN32
+    return GET_KEY();
+#else
+    if (inputStart == inputEnd)
+    {
+        ssize_t length = read(STDIN_FILENO, inputBuffer, sizeof(inputBuffer));
+        if (length <= 0)
+        {
+            return EOF;
+        }
+        inputStart = 0;
+        inputEnd = length;
+    }
+    return inputBuffer[inputStart++];
+#endif
+}
+
+// Reads a line without its line break. The app exits when input ends.
+void readLine(char *buffer, size_t size)
+{
+#ifdef _WIN32
+    if (fgets(buffer, (int)size, stdin) == NULL)
+    {
+        exitApp();
+    }
+    buffer[strcspn(buffer, "\r\n")] = '\0';
+#else
+    size_t length = 0;
+    int character;
+    while ((character = readInputByte()) != '\n')
+    {
+        if (character == EOF)
+        {
+            if (length == 0)
+            {
+                exitApp();
+            }
+            break;
+        }
+        if (character != '\r' && length + 1 < size)
+        {
+            buffer[length++] = character;
+        }
+    }
+    buffer[length] = '\0';
+#endif
+}
+
+// Indexes that would otherwise be built by the first search or list are
+// built while the app waits for a key instead, a slice of notes at a time so
+// a key is never kept waiting for a whole index.
+bool idleWorkPending()
+{
+    return !dateIndexReady || !searchIndexReady || !trigramIndexReady;
+}
+
+void runIdleTask()
+{
+    if (!dateIndexReady)
+    {
+        buildDateIndexSlice(IDLE_TASK_NOTE_LIMIT);
+    }
+    else if (!searchIndexReady)
+    {
+        buildSearchIndexSlice(IDLE_TASK_NOTE_LIMIT);
+    }
+    else if (!trigramIndexReady)
+    {
+        buildTrigramIndexSlice(IDLE_TASK_NOTE_LIMIT);
+    }
+}
+
+// Waits for one key, running idle work whenever the user pauses. Arrow and
+// page keys arrive as escape sequences (or a 0/224 prefix on Windows) and are
+// returned as a SpecialKey.
+int readKey()
+{
+    presentScreen();
+    setRawMode(true);
+    int delay = IDLE_TASK_DELAY_MS;
+    while (!waitForInput(idleWorkPending() ? delay : -1))
+    {
+        runIdleTask();
+        // once the user has paused, slices follow each other until a key
+        delay = 0;
+    }
+    int key = readInputByte();
+#ifdef _WIN32
+    if (key == 0 || key == 224)
+    {
+        switch (readInputByte())
+        {
+        case 72: key = KEY_UP; break;
+        case 80: key = KEY_DOWN; break;
+        case 75: key = KEY_LEFT; break;
+        case 77: key = KEY_RIGHT; break;
+        case 73: key = KEY_PAGE_UP; break;
+        case 81: key = KEY_PAGE_DOWN; break;
+        }
+    }
+#else
+    if (key == '\033' && waitForInput(ESCAPE_SEQUENCE_DELAY_MS))
+    {
+        int prefix = readInputByte();
+        int code = (prefix == '[' || prefix == 'O') && waitForInput(ESCAPE_SEQUENCE_DELAY_MS) ? readInputByte() : EOF;
+        int number = 0;
+        while (code >= '0' && code <= '9' && waitForInput(ESCAPE_SEQUENCE_DELAY_MS))
+        {
+            number = number * 10 + code - '0';
+            code = readInputByte();
+        }
+        if (code == 'A') key = KEY_UP;
+        if (code == 'B') key = KEY_DOWN;
+        if (code == 'C') key = KEY_RIGHT;
+        if (code == 'D') key = KEY_LEFT;
+        if (code == '~' && number == 5) key = KEY_PAGE_UP;
+        if (code == '~' && number == 6) key = KEY_PAGE_DOWN;
+    }
+#endif
+    setRawMode(false);
+    if (key == 3)
+    {
+        exitApp();
+    }
+    return key;
+}
+
+void pauseScreen()
+{
+    printf("%s\n", getTranslation("pressAnyKey"));
+    readKey();
+}
+
+int getScreenRows()
+{
+#ifdef _WIN32
+    CONSOLE_SCREEN_BUFFER_INFO info;
+    if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info))
+    {
+        return info.srWindow.Bottom - info.srWindow.Top + 1;
+    }
+#else
+    struct winsize size;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row > 0)
+    {
+        return size.ws_row;
+    }
+#endif
+    return DEFAULT_SCREEN_ROWS;
+}
+
+// Picking lists show one title per row plus a back row after the last note;
+// with content every row is a full note summary and the top row is the
+// selected one.
+void drawNoteList(struct NoteListView *view, const char *title, const char *instructions)
+{
+    int screenRows = getScreenRows();
+    size_t rows = screenRows > 3 ? screenRows - 3 : 1;
+    view->pageSize = view->withContent ? rows / NOTE_SUMMARY_LINES : rows;
+    if (view->pageSize == 0)
+    {
+        view->pageSize = 1;
+    }
+    view->count = view->fuzzy && view->filter.length > 0 ? view->matchCount : getFilteredRowCount(&view->filter, dateIndexCount);
+    size_t rowCount = view->withContent ? view->count : view->count + 1;
+    if (view->selected >= rowCount)
+    {
+        view->selected = rowCount > 0 ? rowCount - 1 : 0;
+    }
+    size_t first = view->withContent ? view->selected : view->selected - view->selected % view->pageSize;
+    size_t last = first + view->pageSize < rowCount ? first + view->pageSize : rowCount;
+    char text[MESSAGE_BUFFER_SIZE];
+    clearScreen();
+    printf("---- %s ----\n", title);
+    if (view->withContent)
+    {
+        fputs(NOTE_SEPARATOR, stdout);
+    }
+    for (size_t index = first; index < last; index++)
+    {
+        if (index == view->count)
+        {
+            index == view->selected ? printf(" >> %s << \n", getTranslation("back")) : printf(" > %s < \n", getTranslation("back"));
+            continue;
+        }
+        struct Note *note = getNoteListNote(view, index);
+        if (view->withContent)
+        {
+            struct TextBuffer output = {text, sizeof(text), 0};
+            formatNoteSummary(&output, note, true);
+            fputs(text, stdout);
+            continue;
+        }
+        const char *noteTitle = getNoteMenuItem(note)->title;
+        index == view->selected ? printf(" >> %s << \n", noteTitle) : printf(" > %s < \n", noteTitle);
+    }
+    char firstText[21];
+    char lastText[21];
+    char countText[21];
+    sprintf(firstText, "%zu", first + 1 < view->count ? first + 1 : view->count);
+    sprintf(lastText, "%zu", last < view->count ? last : view->count);
+    sprintf(countText, "%zu", view->count);
+    const char *values[TEMPLATE_FIELD_COUNT] = {NULL};
+    values[TEMPLATE_FIRST] = firstText;
+    values[TEMPLATE_LAST] = lastText;
+    values[TEMPLATE_COUNT] = countText;
+    printMessage("noteListPosition", values);
+    drawRowFilter(&view->filter);
+    printf("%s", instructions);
+}
+
+struct Note *getNoteListNote(const struct NoteListView *view, size_t index)
+{
+    if (view->fuzzy && view->filter.length > 0)
+    {
+        return view->matches[index].note;
+    }
+    return dateIndex[getFilteredRow(&view->filter, index)].noteNode->note;
+}
+
+const char *getNoteListTitle(size_t row, void *_)
+{
+    (void)_;
+    return dateIndex[row].noteNode->note->title;
+}
+
+// Pages through every note: w and s move one row, a and d one page, g jumps
+// to a note by its number, / filters by title and e selects. Without an
+// action e goes back.
+void showNoteList(void (*action)(void *), const char *titleTranslationKey, const char *instructionsTranslationKey, bool withContent, bool fuzzy)
+{
+    buildDateIndex();
+    struct NoteListView view = {.count = dateIndexCount, .pageSize = 1, .withContent = withContent, .fuzzy = fuzzy};
+    while (dateIndexCount > 0)
+    {
+        drawNoteList(&view, getTranslation(titleTranslationKey), getTranslation(instructionsTranslationKey));
+        size_t rowCount = withContent ? view.count : view.count + 1;
+        int input = readKey();
+        if (input == EOF)
+        {
+            break;
+        }
+        // a fuzzy list gives the filter no rows to scan, it ranks titles instead
+        if (handleFilterKey(&view.filter, input, fuzzy ? 0 : dateIndexCount, getNoteListTitle, NULL))
+        {
+            view.matchCount = fuzzy ? findFuzzyTitles(view.filter.text, view.matches, FUZZY_RESULTS_LIMIT) : 0;
+            view.selected = 0;
+            continue;
+        }
+        if (input == 'e' || input == 'E' || input == KEY_RIGHT)
+        {
+            struct Note *note = view.selected < view.count ? getNoteListNote(&view, view.selected) : NULL;
+            clearRowFilter(&view.filter);
+            if (action != NULL && note != NULL)
+            {
+                action(getNoteMenuItem(note)->key);
+            }
+            return;
+        }
+        if (rowCount == 0)
+        {
+            continue;
+        }
+        if (input == 'w' || input == 'W' || input == KEY_UP)
+        {
+            view.selected = view.selected > 0 ? view.selected - 1 : rowCount - 1;
+        }
+        if (input == 's' || input == 'S' || input == KEY_DOWN)
+        {
+            view.selected = view.selected + 1 < rowCount ? view.selected + 1 : 0;
+        }
+        if (input == 'a' || input == 'A' || input == KEY_PAGE_UP)
+        {
+            view.selected = view.selected > view.pageSize ? view.selected - view.pageSize : 0;
+        }
+        if (input == 'd' || input == 'D' || input == KEY_PAGE_DOWN)
+        {
+            view.selected = view.selected + view.pageSize < rowCount ? view.selected + view.pageSize : rowCount - 1;
+        }
+        if (input == 'g' || input == 'G')
+        {
+            noteListLength = view.count;
+            clearScreen();
+            char *number = getInput(getTranslation("getInputNoteNumber"), noteNumberValidator, true);
+            if (number != NULL)
+            {
+                view.selected = strtoull(number, NULL, 10) - 1;
+                free(number);
+            }
+        }
+    }
+    clearRowFilter(&view.filter);
+}
+
+size_t getFilteredRowCount(const struct RowFilter *filter, size_t rowCount)
+{
+    return filter->length == 0 ? rowCount : filter->rowCounts[filter->length];
+}
+
+size_t getFilteredRow(const struct RowFilter *filter, size_t position)
+{
+    return filter->length == 0 ? position : filter->rows[filter->length][position];
+}
+
+void pushFilterCharacter(struct RowFilter *filter, char character, size_t rowCount, const char *(*getRowTitle)(size_t, void *), void *data)
+{
+    if (filter->length == FILTER_TEXT_LIMIT)
+    {
+        return;
+    }
+    size_t candidateCount = getFilteredRowCount(filter, rowCount);
+    uint32_t *rows = malloc((candidateCount > 0 ? candidateCount : 1) * sizeof(uint32_t));
+    size_t count = 0;
+    filter->text[filter->length] = character;
+    filter->text[filter->length + 1] = '\0';
+    // Titles are scattered over memory in row order. Looking up a batch of
+    // them first and prefetching ahead of the search keeps many cache misses
+    // in flight; one title at a time the mispredicted match branches
+    // serialize them, which made a million titles four times slower.
+    const char *titles[FILTER_BATCH_SIZE];
+    for (size_t batch = 0; batch < candidateCount; batch += FILTER_BATCH_SIZE)
+    {
+        size_t batchCount = candidateCount - batch < FILTER_BATCH_SIZE ? candidateCount - batch : FILTER_BATCH_SIZE;
+        for (size_t i = 0; i < batchCount; i++)
+        {
+            titles[i] = getRowTitle(getFilteredRow(filter, batch + i), data);
+        }
+        for (size_t i = 0; i < batchCount; i++)
+        {
+            if (i + FILTER_PREFETCH_DISTANCE < batchCount)
+            {
+                PREFETCH(titles[i + FILTER_PREFETCH_DISTANCE]);
+            }
+            if (findPattern(titles[i], titles[i] + strlen(titles[i]), filter->text, filter->length + 1, true) != NULL)
+            {
+                rows[count++] = getFilteredRow(filter, batch + i);
+            }
+        }
+    }
+    filter->length++;
+    filter->rows[filter->length] = rows;
+    filter->rowCounts[filter->length] = count;
+}
+
+void popFilterCharacter(struct RowFilter *filter)
+{
+    if (filter->length == 0)
+    {
+        return;
+    }
+    free(filter->rows[filter->length]);
+    filter->length--;
+    filter->text[filter->length] = '\0';
+}
+
+void clearRowFilter(struct RowFilter *filter)
+{
+    while (filter->length > 0)
+    {
+        popFilterCharacter(filter);
+    }
+    filter->typing = false;
+}
+
+// / starts typing a filter. While typing, characters and backspace change
+// it, enter keeps it and goes back to the usual keys, escape drops it.
+// Returns false for keys the list should handle itself.
+bool handleFilterKey(struct RowFilter *filter, int key, size_t rowCount, const char *(*getRowTitle)(size_t, void *), void *data)
+{
+    if (!filter->typing)
+    {
+        filter->typing = key == '/';
+        return filter->typing;
+    }
+    if (key == '\n' || key == '\r')
+    {
+        filter->typing = false;
+    }
+    else if (key == 27)
+    {
+        clearRowFilter(filter);
+    }
+    else if (key == 127 || key == 8)
+    {
+        popFilterCharacter(filter);
+    }
+    else if (key >= 32 && key < 127)
+    {
+        pushFilterCharacter(filter, key, rowCount, getRowTitle, data);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+void drawRowFilter(const struct RowFilter *filter)
+{
+    if (filter->typing || filter->length > 0)
+    {
+        printf("/%s%s\n", filter->text, filter->typing ? "_" : "");
+    }
+}
+
+// Opens a menu on top of the current one and returns once it is closed.
+// Every open menu is served by the same loop, so moving around a menu uses no
+// extra stack however long the session runs.
+void showMenu(struct MenuItem **menuItems, char *titleTranslationKey, char *instructionsTranslationKey)
+{
+    if (menuStackDepth == MENU_STACK_LIMIT)
+    {
+        return;
+    }
+    struct MenuState *menu = &menuStack[menuStackDepth];
+    menu->items = menuItems;
+    menu->itemCount = getMenuItemCount(menuItems);
+    menu->selectedItem = 0;
+    menu->drawn = false;
+    menu->titleTranslationKey = titleTranslationKey;
+    menu->instructionsTranslationKey = instructionsTranslationKey;
+    menu->filter.length = 0;
+    menu->filter.typing = false;
+    menu->filter.text[0] = '\0';
+    menuStackDepth++;
+    runMenuLoop(menuStackDepth - 1);
+}
+
+void runMenuLoop(int depth)
+{
+    while (menuStackDepth > depth)
+    {
+        struct MenuState *menu = &menuStack[menuStackDepth - 1];
+        if (!menu->drawn)
+        {
+            drawMenu(menu);
+        }
+        handleMenuInput(menu, readKey());
+    }
+}
+
+void drawMenu(struct MenuState *menu)
+{
+    const char *title = getTranslation(menu->titleTranslationKey);
+    const char *instructions = getTranslation(menu->instructionsTranslationKey);
+    int visibleCount = getFilteredRowCount(&menu->filter, menu->itemCount);
+    if (menu->selectedItem > visibleCount - 1)
+    {
+        menu->selectedItem = 0;
+    }
+    clearScreen();
+    title != NULL ? printf("---- %s ----\n", title) : printf("---- %s ----\n", getTranslation("firstMenuTitle"));
+    for (int index = 0; index < menu->itemCount; index++)
+    {
+        if (menu->items[index]->getTranslation)
+            menu->items[index]->title = getTranslation(menu->items[index]->key);
+    }
+    for (int index = 0; index < visibleCount; index++)
+    {
+        drawMenuItem(menu->items[getFilteredRow(&menu->filter, index)], index == menu->selectedItem);
+        printf("\n");
+    }
+    drawRowFilter(&menu->filter);
+    instructions != NULL ? printf("%s", instructions) : printf("%s", getTranslation("firstMenuIndication"));
+    menu->drawn = true;
+}
+
+void drawMenuItem(const struct MenuItem *menuItem, bool selected)
+{
+    selected ? printf(" >> %s << ", menuItem->title) : printf(" > %s < ", menuItem->title);
+}
+
+// The menu on screen only differs in the old and new selected rows, so those
+// two lines are rewritten in place and the cursor goes back after the
+// instructions. Returns false when the menu is taller than the terminal and
+// has scrolled, since the rows are then no longer where they were drawn.
+bool moveMenuSelection(struct MenuState *menu, int oldItem, int newItem)
+{
+    int visibleCount = getFilteredRowCount(&menu->filter, menu->itemCount);
+    int instructionsRow = visibleCount + 2;
+    if (menu->filter.typing || menu->filter.length > 0)
+    {
+        instructionsRow++;
+    }
+    if (instructionsRow > getScreenRows())
+    {
+        return false;
+    }
+    printf("\033[%d;1H\033[2K", oldItem + 2);
+    drawMenuItem(menu->items[getFilteredRow(&menu->filter, oldItem)], false);
+    printf("\033[%d;1H\033[2K", newItem + 2);
+    drawMenuItem(menu->items[getFilteredRow(&menu->filter, newItem)], true);
+    printf("\033[%d;%dH", instructionsRow, (int)strlen(getTranslation(menu->instructionsTranslationKey)) + 1);
+    return true;
+}
+
+const char *getMenuItemTitle(size_t row, void *menu)
+{
+    return ((struct MenuState *)menu)->items[row]->title;
+}
+
+void handleMenuInput(struct MenuState *menu, int input)
+{
+    if (input == EOF)
+    {
+        exitApp();
+    }
+    if (handleFilterKey(&menu->filter, input, menu->itemCount, getMenuItemTitle, menu))
+    {
+        menu->selectedItem = 0;
+        menu->drawn = false;
+        return;
+    }
+    int visibleCount = getFilteredRowCount(&menu->filter, menu->itemCount);
+    if (visibleCount == 0)
+    {
+        return;
+    }
+    if (input == 'w' || input == 'W' || input == KEY_UP || input == 's' || input == 'S' || input == KEY_DOWN)
+    {
+        int oldItem = menu->selectedItem;
+        menu->selectedItem += (input == 'w' || input == 'W' || input == KEY_UP) ? -1 : 1;
+        menu->selectedItem = (menu->selectedItem + visibleCount) % visibleCount;
+        menu->drawn = moveMenuSelection(menu, oldItem, menu->selectedItem);
+        return;
+    }
+    if (input == 'e' || input == 'E' || input == KEY_RIGHT)
+    {
+        struct MenuItem *menuItem = menu->items[getFilteredRow(&menu->filter, menu->selectedItem)];
+        // deleting a note frees its menu item, so decide before running the action
+        bool stay = stayInMenu(menuItem->key);
+        menuItem->action(menuItem->key);
+        menu->drawn = false;
+        if (!stay)
+        {
+            clearRowFilter(&menu->filter);
+            menuStackDepth--;
+        }
+    }
+}
+
+void initializeFirstItems(struct MenuItem **menuItems)
+{
+    struct MenuItem *addNotesMenuItem = malloc(sizeof(struct MenuItem));
+    addNotesMenuItem->key = "addNoteAction";
+    addNotesMenuItem->title = NULL;
+    addNotesMenuItem->action = addNoteAction;
+    addNotesMenuItem->getTranslation = true;
+    menuItems[0] = addNotesMenuItem;
+
+    struct MenuItem *deleteNotesMenuItem = malloc(sizeof(struct MenuItem));
+    deleteNotesMenuItem->key = "deleteNoteAction";
+    deleteNotesMenuItem->title = NULL;
+    deleteNotesMenuItem->action = deleteNoteAction;
+    deleteNotesMenuItem->getTranslation = true;
+    menuItems[1] = deleteNotesMenuItem;
+
+    struct MenuItem *editNotesMenuItem = malloc(sizeof(struct MenuItem));
+    editNotesMenuItem->key = "editNoteAction";
+    editNotesMenuItem->title = NULL;
+    editNotesMenuItem->action = editNoteAction;
+    editNotesMenuItem->getTranslation = true;
+    menuItems[2] = editNotesMenuItem;
+
+    struct MenuItem *viewNotesMenuItem = malloc(sizeof(struct MenuItem));
+    viewNotesMenuItem->key = "viewNotes";
+    viewNotesMenuItem->title = NULL;
+    viewNotesMenuItem->action = viewNotes;
+    viewNotesMenuItem->getTranslation = true;
+    menuItems[3] = viewNotesMenuItem;
+
+    struct MenuItem *viewNotesMenuItemByDate = malloc(sizeof(struct MenuItem));
+    viewNotesMenuItemByDate->key = "viewNotesByDate";
+    viewNotesMenuItemByDate->title = NULL;
+    viewNotesMenuItemByDate->action = viewNotesByDate;
+    viewNotesMenuItemByDate->getTranslation = true;
+    menuItems[4] = viewNotesMenuItemByDate;
+
+    struct MenuItem *viewNotesByDateRangeMenuItem = malloc(sizeof(struct MenuItem));
+    viewNotesByDateRangeMenuItem->key = "viewNotesByDateRange";
+    viewNotesByDateRangeMenuItem->title = NULL;
+    viewNotesByDateRangeMenuItem->action = viewNotesByDateRange;
+    viewNotesByDateRangeMenuItem->getTranslation = true;
+    menuItems[5] = viewNotesByDateRangeMenuItem;
+
+    struct MenuItem *viewLatestNotesMenuItem = malloc(sizeof(struct MenuItem));
+    viewLatestNotesMenuItem->key = "viewLatestNotes";
+    viewLatestNotesMenuItem->title = NULL;
+    viewLatestNotesMenuItem->action = viewLatestNotes;
+    viewLatestNotesMenuItem->getTranslation = true;
+    menuItems[6] = viewLatestNotesMenuItem;
+
+    struct MenuItem *searchNotesMenuItem = malloc(sizeof(struct MenuItem));
+    searchNotesMenuItem->key = "searchNotesAction";
+    searchNotesMenuItem->title = NULL;
+    searchNotesMenuItem->action = searchNotesAction;
+    searchNotesMenuItem->getTranslation = true;
+    menuItems[7] = searchNotesMenuItem;
+
+    struct MenuItem *grepNotesMenuItem = malloc(sizeof(struct MenuItem));
+    grepNotesMenuItem->key = "grepNotesAction";
+    grepNotesMenuItem->title = NULL;
+    grepNotesMenuItem->action = grepNotesAction;
+    grepNotesMenuItem->getTranslation = true;
+    menuItems[8] = grepNotesMenuItem;
+
+    struct MenuItem *settingsMenuItem = malloc(sizeof(struct MenuItem));
+    settingsMenuItem->key = "settingsAction";
+    settingsMenuItem->title = NULL;
+    settingsMenuItem->action = settingsAction;
+    settingsMenuItem->getTranslation = true;
+    menuItems[9] = settingsMenuItem;
+
+    struct MenuItem *exitMenuItem = malloc(sizeof(struct MenuItem));
+    exitMenuItem->key = "exit";
+    exitMenuItem->title = NULL;
+    exitMenuItem->action = exitApp;
+    exitMenuItem->getTranslation = true;
+    menuItems[10] = exitMenuItem;
+
+    menuItems[11] = NULL;
+}
+
+// notes.txt and the journal start with NOTES_TEXT_HEADER; files from older
+// versions have pipe delimited records and no header.
+size_t getTextHeaderLength(const char *data, size_t size)
+{
+    size_t length = strlen(NOTES_TEXT_HEADER);
+    return size >= length && memcmp(data, NOTES_TEXT_HEADER, length) == 0 ? length : 0;
+}
+
+// Reads one record written by writeNoteRecord() in a single pass, without
+// touching the buffer: the title and content are views into it. On success
+// position moves past the record's line break; a malformed or cut short
+// record returns false and leaves it where it was.
+bool parseNoteRecord(const char **position, const char *end, struct NoteRecordView *record)
+{
+    const char *current = parseRecordNumber(*position, end, &record->id);
+    if (current == NULL || current == end || *current != '|')
+    {
+        return false;
+    }
+    current = parseRecordText(current + 1, end, &record->title);
+    current = current == NULL ? NULL : parseRecordText(current, end, &record->content);
+    current = current == NULL ? NULL : parseRecordTimestamp(current, end, &record->timestamp);
+    if (current == NULL || current == end || *current != '\n')
+    {
+        return false;
+    }
+    *position = current + 1;
+    return true;
+}
+
+// The lines of older versions: key|title|content|timestamp, or
+// key|title|content|day|month|year|hour|minute before that. A | in the text
+// cannot be told apart from a separator there.
+bool parseLegacyNoteRecord(const char **position, const char *end, struct NoteRecordView *record)
+{
+    const char *lineEnd = memchr(*position, '\n', end - *position);
+    lineEnd = lineEnd != NULL ? lineEnd : end;
+    struct TextView fields[8];
+    int count = 0;
+    for (const char *field = *position; count < 8; count++)
+    {
+        const char *separator = memchr(field, '|', lineEnd - field);
+        fields[count].text = field;
+        fields[count].length = (separator != NULL ? separator : lineEnd) - field;
+        if (separator == NULL)
+        {
+            count++;
+            break;
+        }
+        field = separator + 1;
+    }
+    if (count != 4 && count != 8)
+    {
+        return false;
+    }
+    int32_t numbers[5] = {0, 0, 0, 0, 0};
+    for (int i = 3; i < count; i++)
+    {
+        parseRecordTimestamp(fields[i].text, fields[i].text + fields[i].length, &numbers[i - 3]);
+    }
+    if (count == 8)
+    {
+        struct Date date = {numbers[0], numbers[1], numbers[2], numbers[3], numbers[4]};
+        numbers[0] = makeTimestamp(&date);
+    }
+    parseRecordNumber(fields[0].text, fields[0].text + fields[0].length, &record->id);
+    record->title = fields[1];
+    record->content = fields[2];
+    record->timestamp = numbers[0];
+    *position = lineEnd < end ? lineEnd + 1 : end;
+    return true;
+}
+
+// Reads a decimal number, or returns NULL when there is none.
+const char *parseRecordNumber(const char *position, const char *end, uint64_t *value)
+{
+    const char *start = position;
+    *value = 0;
+    while (position < end && *position >= '0' && *position <= '9')
+    {
+        *value = *value * 10 + (*position - '0');
+        position++;
+    }
+    return position == start ? NULL : position;
+}
+
+const char *parseRecordTimestamp(const char *position, const char *end, int32_t *timestamp)
+{
+    bool negative = position < end && *position == '-';
+    uint64_t value;
+    position = parseRecordNumber(position + negative, end, &value);
+    *timestamp = negative ? -(int32_t)value : (int32_t)value;
+    return position;
+}
+
+// Reads length:text| and returns the position after the |.
+const char *parseRecordText(const char *position, const char *end, struct TextView *view)
+{
+    uint64_t length;
+    position = parseRecordNumber(position, end, &length);
+    if (position == NULL || position == end || *position != ':' || length >= (uint64_t)(end - position - 1))
+    {
+        return NULL;
+    }
+    view->text = position + 1;
+    view->length = length;
+    position += 1 + length;
+    return *position == '|' ? position + 1 : NULL;
+}
+
+// The record's text is copied into the string arena, so the buffer it was
+// read from can go away.
+struct Note *copyNoteRecord(const struct NoteRecordView *record)
+{
+    struct Note *note = slabAllocate(&noteSlab);
+    note->id = record->id;
+    note->title = copyString(record->title.text, record->title.length);
+    note->content = copyString(record->content.text, record->content.length);
+    note->timestamp = record->timestamp;
+    note->menuItem = NULL;
+    return note;
+}
+
+char *mapFile(const char *path, size_t *size)
+{
+#ifdef _WIN32
+    FILE *file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    *size = getFileSize(file);
+    char *data = malloc(*size);
+    if (data != NULL && fread(data, 1, *size, file) != *size)
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    return data;
+#else
+    int descriptor = open(path, O_RDONLY);
+    if (descriptor == -1)
+    {
+        return NULL;
+    }
+    struct stat fileStatus;
+    char *data = NULL;
+    if (fstat(descriptor, &fileStatus) == 0 && fileStatus.st_size > 0)
+    {
+        *size = fileStatus.st_size;
+        data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (data == MAP_FAILED)
+        {
+            data = NULL;
+        }
+    }
+    close(descriptor);
+    return data;
+#endif
+}
+
+void unmapFile(char *data, size_t size)
+{
+#ifdef _WIN32
+    free(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+// Only the header and record table are read here; titles and contents are
+// referenced in place and their pages are faulted in when first displayed.
+bool loadNotesBinary()
+{
+    size_t size = 0;
+    char *data = mapFile(NOTES_BINARY_FILE, &size);
+    if (data == NULL)
+    {
+        return false;
+    }
+    const struct NotesFileHeader *header = (const struct NotesFileHeader *)data;
+    if (size < sizeof(struct NotesFileHeader))
+    {
+        unmapFile(data, size);
+        return false;
+    }
+    size_t recordSize = header->version == 1 ? sizeof(struct NotesFileRecordV1) : sizeof(struct NotesFileRecord);
+    if (header->magic != NOTES_BINARY_MAGIC || header->version < 1 || header->version > NOTES_BINARY_VERSION ||
+        header->heapOffset != sizeof(struct NotesFileHeader) + header->recordCount * recordSize ||
+        header->heapOffset + header->heapSize != size || (header->heapSize > 0 && data[size - 1] != '\0'))
+    {
+        unmapFile(data, size);
+        return false;
+    }
+    notesMap = data;
+    notesMapSize = size;
+    notesMapVersion = header->version;
+    reserveNoteIndex(header->recordCount);
+    slabReserve(&noteSlab, header->recordCount);
+    slabReserve(&noteNodeSlab, header->recordCount);
+    const char *records = data + sizeof(struct NotesFileHeader);
+    char *heap = data + header->heapOffset;
+    for (uint64_t index = 0; index < header->recordCount; index++)
+    {
+        const struct NotesFileRecord *record = (const struct NotesFileRecord *)(records + index * recordSize);
+        if (record->titleOffset >= header->heapSize || record->contentOffset >= header->heapSize)
+        {
+            continue;
+        }
+        struct Note *note = slabAllocate(&noteSlab);
+        note->title = heap + record->titleOffset;
+        note->content = heap + record->contentOffset;
+        if (header->version == 1)
+        {
+            const struct NotesFileRecordV1 *recordV1 = (const struct NotesFileRecordV1 *)record;
+            struct Date date = {recordV1->day, recordV1->month, recordV1->year, recordV1->hour, recordV1->minute};
+            note->timestamp = makeTimestamp(&date);
+        }
+        else
+        {
+            note->timestamp = record->timestamp;
+        }
+        note->id = record->key;
+        note->menuItem = NULL;
+        linkNoteNode(note);
+    }
+    return true;
+}
+
+// The whole file is mapped and parsed in place; the text of every note is
+// copied once, into a string arena block reserved for all of it.
+void loadNotesText(const char *path)
+{
+    size_t size = 0;
+    char *data = mapFile(path, &size);
+    if (data == NULL)
+    {
+        return;
+    }
+    const char *end = data + size;
+    const char *position = data + getTextHeaderLength(data, size);
+    bool legacy = position == data;
+    arenaReserve(&stringArena, size);
+    while (position < end)
+    {
+        struct NoteRecordView record;
+        if (legacy ? !parseLegacyNoteRecord(&position, end, &record) : !parseNoteRecord(&position, end, &record))
+        {
+            position = skipLine(position, end);
+            continue;
+        }
+        addNoteToList(copyNoteRecord(&record));
+    }
+    unmapFile(data, size);
+}
+
+// Releases every note, string and index in one go.
+void freeNotesList()
+{
+    freeSlab(&noteSlab);
+    freeSlab(&noteNodeSlab);
+    freeSlab(&menuItemSlab);
+    freeArena(&stringArena);
+    free(noteIndex);
+    noteIndex = NULL;
+    noteIndexCapacity = 0;
+    noteIndexCount = 0;
+    free(dateIndex);
+    dateIndex = NULL;
+    dateIndexCount = 0;
+    dateIndexCapacity = 0;
+    dateIndexReady = false;
+    dateIndexCursor = NULL;
+    freeSearchIndex();
+    free(grepSpans);
+    grepSpans = NULL;
+    grepSpanCount = 0;
+    grepSpanCapacity = 0;
+    grepSpansReady = false;
+    freeTrigramIndex();
+    if (notesMap != NULL)
+    {
+        unmapFile(notesMap, notesMapSize);
+    }
+    notesMap = NULL;
+    notesMapSize = 0;
+    notesList = NULL;
+    notesListTail = NULL;
+}
+
+// notes.bin is the snapshot; a tree that only has the old pipe delimited
+// notes.txt, or an older notes.bin, is converted on its first start.
+void initializeNotesList()
+{
+    bool loadedBinary = loadNotesBinary();
+    FILE *rejected = loadedBinary ? NULL : fopen(NOTES_BINARY_FILE, "rb");
+    if (rejected != NULL)
+    {
+        // a damaged or newer snapshot is kept aside, never overwritten by a
+        // compaction
+        fclose(rejected);
+        if (!REPLACE_FILE(NOTES_BINARY_FILE, NOTES_BINARY_REJECTED_FILE))
+        {
+            fprintf(stderr, "%s cannot be read or moved to %s\n", NOTES_BINARY_FILE, NOTES_BINARY_REJECTED_FILE);
+            exit(COMMAND_WRITE_FAILED);
+        }
+        fprintf(stderr, "%s cannot be read and was moved to %s\n", NOTES_BINARY_FILE, NOTES_BINARY_REJECTED_FILE);
+    }
+    // while a rejected snapshot waits aside only the journal is loaded, since
+    // notes.txt may be older than it, and nothing is compacted at startup
+    FILE *keptAside = loadedBinary ? NULL : fopen(NOTES_BINARY_REJECTED_FILE, "rb");
+    if (keptAside != NULL)
+    {
+        fclose(keptAside);
+    }
+    else if (!loadedBinary)
+    {
+        loadNotesText(NOTES_FILE);
+    }
+    bool oldJournal = replayJournal();
+    bool converted = keptAside == NULL && ((!loadedBinary && notesList != NULL) || (loadedBinary && notesMapVersion != NOTES_BINARY_VERSION));
+    if (oldJournal || converted)
+    {
+        // reload from the converted snapshot so the text is mapped instead of copied
+        if (compactNotes())
+        {
+            freeNotesList();
+            loadNotesBinary();
+        }
+    }
+    else if (keptAside == NULL)
+    {
+        compactNotesIfNeeded();
+    }
+}
+
+void initConfig()
+{
+    FILE *file = fopen("config.txt", "r");
+    config = malloc(sizeof(struct Config));
+    char *line = malloc(sizeof(char) * config->MAX_CONTENT_LENGTH);
+    size_t len = 0;
+    config->JOURNAL_COMPACT_THRESHOLD = 65536;
+    if (file == NULL || getFileSize(file) == 0)
+    {
+        config->MAX_TITLE_LENGTH = 100;
+        config->MAX_CONTENT_LENGTH = 1000;
+        config->MAX_DATE_LENGTH = 16;
+        config->MAX_MESSAGE_LENGTH = 100;
+        config->MAX_NOTES_COUNT = 100;
+        config->color = WHITE;
+        config->language = ENGLISH;
+        saveConfig();
+        return;
+    }
+    while (getline(&line, &len, file) != -1)
+    {
+        char *key = strtok(line, "|");
+        char *value = strtok(NULL, "|");
+        if (strcmp(key, "maxTitleLength") == 0)
+        {
+            config->MAX_TITLE_LENGTH = atoi(value);
+        }
+        if (strcmp(key, "maxContentLength") == 0)
+        {
+            config->MAX_CONTENT_LENGTH = atoi(value);
+        }
+        if (strcmp(key, "maxDateLength") == 0)
+        {
+            config->MAX_DATE_LENGTH = atoi(value);
+        }
+        if (strcmp(key, "maxMessageLength") == 0)
+        {
+            config->MAX_MESSAGE_LENGTH = atoi(value);
+        }
+        if (strcmp(key, "maxNotesCount") == 0)
+        {
+            config->MAX_NOTES_COUNT = atoi(value);
+        }
+        if (strcmp(key, "color") == 0)
+        {
+            config->color = atoi(value);
+        }
+        if (strcmp(key, "language") == 0)
+        {
+            config->language = atoi(value);
+        }
+        if (strcmp(key, "journalCompactThreshold") == 0)
+        {
+            config->JOURNAL_COMPACT_THRESHOLD = atoi(value);
+        }
+    }
+    free(line);
+    fclose(file);
+}
+
+static const char *const templateFieldNames[TEMPLATE_FIELD_COUNT] = {NULL, "title", "content", "date", "time", "count", "first", "last"};
+
+// Splits text at every #name that names a field; any other # is kept as text.
+struct MessageTemplate *compileMessageTemplate(const char *text)
+{
+    size_t maxSegments = 1;
+    for (const char *c = text; *c != '\0'; c++)
+    {
+        maxSegments += *c == '#' ? 2 : 0;
+    }
+    struct MessageTemplate *messageTemplate = arenaAllocate(&messageTemplateArena, sizeof(struct MessageTemplate) + maxSegments * sizeof(struct TemplateSegment), sizeof(void *));
+    messageTemplate->source = text;
+    messageTemplate->segmentCount = 0;
+    const char *literal = text;
+    const char *c = text;
+    while (*c != '\0')
+    {
+        size_t nameLength = 0;
+        while (*c == '#' && isalpha((unsigned char)c[1 + nameLength]))
+        {
+            nameLength++;
+        }
+        enum TemplateField field = TEMPLATE_TEXT;
+        for (int i = TEMPLATE_TEXT + 1; nameLength > 0 && i < TEMPLATE_FIELD_COUNT; i++)
+        {
+            if (strlen(templateFieldNames[i]) == nameLength && strncmp(c + 1, templateFieldNames[i], nameLength) == 0)
+            {
+                field = i;
+            }
+        }
+        if (field == TEMPLATE_TEXT)
+        {
+            c++;
+            continue;
+        }
+        if (c > literal)
+        {
+            struct TemplateSegment *segment = &messageTemplate->segments[messageTemplate->segmentCount++];
+            segment->field = TEMPLATE_TEXT;
+            segment->text = literal;
+            segment->length = c - literal;
+        }
+        struct TemplateSegment *segment = &messageTemplate->segments[messageTemplate->segmentCount++];
+        segment->field = field;
+        segment->text = NULL;
+        segment->length = 0;
+        c += nameLength + 1;
+        literal = c;
+    }
+    if (c > literal)
+    {
+        struct TemplateSegment *segment = &messageTemplate->segments[messageTemplate->segmentCount++];
+        segment->field = TEMPLATE_TEXT;
+        segment->text = literal;
+        segment->length = c - literal;
+    }
+    return messageTemplate;
+}
+
+// Templates are compiled the first time a translation is used and cached by
+// the address of the translated text, so switching language just compiles
+// the other column once.
+const struct MessageTemplate *getMessageTemplate(const char *key)
+{
+    const char *text = getTranslation(key);
+    if ((messageTemplateCount + 1) * 2 > messageTemplateCapacity)
+    {
+        struct MessageTemplate **oldTemplates = messageTemplates;
+        size_t oldCapacity = messageTemplateCapacity;
+        messageTemplateCapacity = oldCapacity == 0 ? 64 : oldCapacity * 2;
+        messageTemplates = calloc(messageTemplateCapacity, sizeof(struct MessageTemplate *));
+        for (size_t i = 0; i < oldCapacity; i++)
+        {
+            if (oldTemplates[i] != NULL)
+            {
+                size_t slot = hashNoteKey((uintptr_t)oldTemplates[i]->source) & (messageTemplateCapacity - 1);
+                while (messageTemplates[slot] != NULL)
+                {
+                    slot = (slot + 1) & (messageTemplateCapacity - 1);
+                }
+                messageTemplates[slot] = oldTemplates[i];
+            }
+        }
+        free(oldTemplates);
+    }
+    size_t mask = messageTemplateCapacity - 1;
+    size_t slot = hashNoteKey((uintptr_t)text) & mask;
+    while (messageTemplates[slot] != NULL)
+    {
+        if (messageTemplates[slot]->source == text)
+        {
+            return messageTemplates[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    messageTemplates[slot] = compileMessageTemplate(text);
+    messageTemplateCount++;
+    return messageTemplates[slot];
+}
+
+void appendText(struct TextBuffer *output, const char *text, size_t length)
+{
+    if (output->length < output->size)
+    {
+        size_t room = output->size - output->length - 1;
+        memcpy(output->data + output->length, text, length < room ? length : room);
+        output->data[output->length + (length < room ? length : room)] = '\0';
+    }
+    output->length += length;
+}
+
+// values is indexed by field; a missing value renders as nothing.
+void renderTemplate(struct TextBuffer *output, const struct MessageTemplate *messageTemplate, const char *const *values)
+{
+    for (size_t i = 0; i < messageTemplate->segmentCount; i++)
+    {
+        const struct TemplateSegment *segment = &messageTemplate->segments[i];
+        if (segment->field == TEMPLATE_TEXT)
+        {
+            appendText(output, segment->text, segment->length);
+        }
+        else if (values[segment->field] != NULL)
+        {
+            appendText(output, values[segment->field], strlen(values[segment->field]));
+        }
+    }
+}
+
+// Prints a translation with its placeholders filled in, then a newline.
+void printMessage(const char *key, const char *const *values)
+{
+    char text[MESSAGE_BUFFER_SIZE];
+    struct TextBuffer output = {text, sizeof(text), 0};
+    renderTemplate(&output, getMessageTemplate(key), values);
+    appendText(&output, "\n", 1);
+    fputs(text, stdout);
+}
+
+uint64_t hashTranslationKey(const char *key)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (; *key != '\0'; key++)
+    {
+        hash ^= (unsigned char)*key;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+struct TranslationEntry *findTranslation(const char *key, bool create)
+{
+    if (create && (translationCount + 1) * 2 > translationCapacity)
+    {
+        struct TranslationEntry *oldTranslations = translations;
+        size_t oldCapacity = translationCapacity;
+        translationCapacity = oldCapacity == 0 ? 128 : oldCapacity * 2;
+        translations = calloc(translationCapacity, sizeof(struct TranslationEntry));
+        for (size_t i = 0; i < oldCapacity; i++)
+        {
+            if (oldTranslations[i].key != NULL)
+            {
+                size_t slot = hashTranslationKey(oldTranslations[i].key) & (translationCapacity - 1);
+                while (translations[slot].key != NULL)
+                {
+                    slot = (slot + 1) & (translationCapacity - 1);
+                }
+                translations[slot] = oldTranslations[i];
+            }
+        }
+        free(oldTranslations);
+    }
+    if (translationCapacity == 0)
+    {
+        return NULL;
+    }
+    size_t mask = translationCapacity - 1;
+    size_t slot = hashTranslationKey(key) & mask;
+    while (translations[slot].key != NULL)
+    {
+        if (strcmp(translations[slot].key, key) == 0)
+        {
+            return &translations[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    if (!create)
+    {
+        return NULL;
+    }
+    translations[slot].key = key;
+    translations[slot].values = NULL;
+    translationCount++;
+    return &translations[slot];
+}
+
+// Same hash and probing as the generator used to lay the table out.
+const struct BuiltinTranslation *findBuiltinTranslation(const char *key)
+{
+    size_t mask = BUILTIN_TRANSLATION_CAPACITY - 1;
+    size_t slot = hashTranslationKey(key) & mask;
+    while (builtinTranslations[slot].key != NULL)
+    {
+        if (strcmp(builtinTranslations[slot].key, key) == 0)
+        {
+            return &builtinTranslations[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+const char *lookupTranslation(const char *key, int language)
+{
+    struct TranslationEntry *translation = findTranslation(key, false);
+    if (translation != NULL && translation->values[language] != NULL)
+    {
+        return translation->values[language];
+    }
+    const struct BuiltinTranslation *builtin = findBuiltinTranslation(key);
+    if (builtin != NULL && language < BUILTIN_TRANSLATION_LANGUAGE_COUNT)
+    {
+        return builtin->values[language];
+    }
+    return NULL;
+}
+
+// The returned text is owned by the catalog and has no trailing newline. A
+// key missing in the current language falls back to English.
+const char *getTranslation(const char *key)
+{
+    const char *value = lookupTranslation(key, config->language);
+    if (value == NULL)
+    {
+        value = lookupTranslation(key, ENGLISH);
+    }
+    return value != NULL ? value : "NOT FOUND, PLEASE ADD IT TO TRANSLATIONS FILE";
+}
+
+// The built-in catalog needs no set up. An override file, in the same
+// key|language 0|language 1|... format as translations.txt, is read once and
+// split in place, its strings staying in translationText.
+void initTranslations()
+{
+    translationLanguageCount = BUILTIN_TRANSLATION_LANGUAGE_COUNT;
+    FILE *file = fopen(TRANSLATIONS_OVERRIDE_FILE, "rb");
+    if (file == NULL || getFileSize(file) == 0)
+    {
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        if (config->language < 0 || config->language >= translationLanguageCount)
+        {
+            config->language = ENGLISH;
+        }
+        return;
+    }
+    int size = getFileSize(file);
+    translationText = malloc(size + 1);
+    size = fread(translationText, 1, size, file);
+    translationText[size] = '\0';
+    fclose(file);
+    int columns = 0;
+    for (const char *c = translationText;; c++)
+    {
+        if (*c == '|')
+        {
+            columns++;
+        }
+        if (*c == '\n' || *c == '\0')
+        {
+            if (columns > translationLanguageCount)
+            {
+                translationLanguageCount = columns;
+            }
+            columns = 0;
+        }
+        if (*c == '\0')
+        {
+            break;
+        }
+    }
+    char *line = translationText;
+    while (*line != '\0')
+    {
+        char *end = strchr(line, '\n');
+        char *next = end == NULL ? line + strlen(line) : end + 1;
+        if (end != NULL)
+        {
+            *end = '\0';
+        }
+        char *field = strchr(line, '|');
+        if (field != NULL && field != line)
+        {
+            *field = '\0';
+            struct TranslationEntry *translation = findTranslation(line, true);
+            if (translation->values == NULL)
+            {
+                translation->values = arenaAllocate(&translationArena, translationLanguageCount * sizeof(char *), sizeof(char *));
+                memset(translation->values, 0, translationLanguageCount * sizeof(char *));
+            }
+            for (int column = 0; field != NULL; column++)
+            {
+                char *value = field + 1;
+                field = strchr(value, '|');
+                if (field != NULL)
+                {
+                    *field = '\0';
+                }
+                size_t length = strlen(value);
+                if (length > 0 && value[length - 1] == '\r')
+                {
+                    value[--length] = '\0';
+                }
+                if (length > 0)
+                {
+                    translation->values[column] = value;
+                }
+            }
+        }
+        line = next;
+    }
+    if (config->language < 0 || config->language >= translationLanguageCount)
+    {
+        config->language = ENGLISH;
+    }
+}
+
+// Commands run without the menus, the screen or the translations, for use
+// from scripts:
+//   add --title T --content C [--date "dd.mm.yyyy hh:mm"]   prints the new id
+//   edit ID [--title T] [--content C] [--date D]
+//   delete ID...
+//   list [--from D] [--to D]
+//   query WORDS... [--limit N]
+//   batch            runs one command per line of standard input, with the
+//                    arguments separated by tabs
+//   import FILE [--format csv|jsonl] [--skip-invalid]   prints the number of
+//                    notes imported
+//   export [--format jsonl|csv] [--from D] [--to D] [--search TEXT]
+//          [--output FILE]
+// A content of - is read from standard input. Notes are printed as
+// id|title|content|dd.mm.yyyy hh:mm, one per line, with the text escaped by
+// printNoteField().
+int runCommand(int argc, char **argv)
+{
+    if (strcmp(argv[0], "add") == 0)
+    {
+        return addNoteCommand(argc, argv);
+    }
+    if (strcmp(argv[0], "edit") == 0)
+    {
+        return editNoteCommand(argc, argv);
+    }
+    if (strcmp(argv[0], "delete") == 0)
+    {
+        return deleteNoteCommand(argc, argv);
+    }
+    if (strcmp(argv[0], "list") == 0)
+    {
+        return listNotesCommand(argc, argv);
+    }
+    if (strcmp(argv[0], "query") == 0)
+    {
+        return queryNotesCommand(argc, argv);
+    }
+    if (strcmp(argv[0], "export") == 0)
+    {
+        return exportNotesCommand(argc, argv);
+    }
+    if (strcmp(argv[0], "import") == 0)
+    {
+        return importNotesCommand(argc, argv);
+    }
+    if (strcmp(argv[0], "batch") == 0 && !batchMode)
+    {
+        return batchCommand();
+    }
+    fprintf(stderr, "Unknown command: %s\n", argv[0]);
+    return COMMAND_INVALID;
+}
+
+// The value following --name, or NULL when the option is not given.
+const char *getCommandOption(int argc, char **argv, const char *name)
+{
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strncmp(argv[i], "--", 2) == 0 && strcmp(argv[i] + 2, name) == 0)
+        {
+            return argv[i + 1];
+        }
+    }
+    return NULL;
+}
+
+// Reads the rest of standard input without its final line break.
+char *readStandardInput()
+{
+    size_t size = 256;
+    size_t length = 0;
+    char *text = malloc(size);
+    size_t count;
+    while ((count = fread(text + length, 1, size - length - 1, stdin)) > 0)
+    {
+        length += count;
+        if (length + 1 == size)
+        {
+            size *= 2;
+            text = realloc(text, size);
+        }
+    }
+    while (length > 0 && (text[length - 1] == '\n' || text[length - 1] == '\r'))
+    {
+        length--;
+    }
+    text[length] = '\0';
+    return text;
+}
+
+void printNoteRecord(const struct Note *note)
+{
+    char date[11];
+    char time[6];
+    formatDate(note->timestamp, date);
+    formatTime(note->timestamp, time);
+    printf("%llu|", (unsigned long long)note->id);
+    printNoteField(note->title);
+    putchar('|');
+    printNoteField(note->content);
+    printf("|%s %s\n", date, time);
+}
+
+// Keeps a printed note on one line with exactly four fields: \, | and line
+// breaks in the text are written as \\, \|, \n and \r.
+void printNoteField(const char *text)
+{
+    while (*text != '\0')
+    {
+        size_t length = strcspn(text, "\\|\r\n");
+        fwrite(text, 1, length, stdout);
+        text += length;
+        if (*text == '\0')
+        {
+            break;
+        }
+        putchar('\\');
+        putchar(*text == '\n' ? 'n' : *text == '\r' ? 'r' : *text);
+        text++;
+    }
+}
+
+int addNoteCommand(int argc, char **argv)
+{
+    const char *title = getCommandOption(argc, argv, "title");
+    const char *content = getCommandOption(argc, argv, "content");
+    const char *date = getCommandOption(argc, argv, "date");
+    if (title == NULL || content == NULL)
+    {
+        fprintf(stderr, "Usage: add --title TITLE --content CONTENT [--date \"dd.mm.yyyy hh:mm\"]\n");
+        return COMMAND_INVALID;
+    }
+    char *input = NULL;
+    if (strcmp(content, "-") == 0 && !batchMode)
+    {
+        content = input = readStandardInput();
+    }
+    const char *error = titleValidator((void *)title);
+    error = error != NULL ? error : contentValidator((void *)content);
+    error = error != NULL || date == NULL ? error : dateValidator((void *)date);
+    if (error != NULL)
+    {
+        fprintf(stderr, "%s", error);
+        free(input);
+        return COMMAND_INVALID;
+    }
+    struct Note *note = slabAllocate(&noteSlab);
+    note->title = copyString(title, strlen(title));
+    note->content = copyString(content, strlen(content));
+    note->timestamp = date != NULL ? parseDate(date) : currentTimestamp();
+    free(input);
+    if (!storeNewNote(note))
+    {
+        fprintf(stderr, "Cannot write %s\n", NOTES_JOURNAL_FILE);
+        return COMMAND_WRITE_FAILED;
+    }
+    printf("%llu\n", (unsigned long long)note->id);
+    return 0;
+}
+
+int editNoteCommand(int argc, char **argv)
+{
+    const char *title = getCommandOption(argc, argv, "title");
+    const char *content = getCommandOption(argc, argv, "content");
+    const char *date = getCommandOption(argc, argv, "date");
+    if (argc < 2 || (title == NULL && content == NULL && date == NULL))
+    {
+        fprintf(stderr, "Usage: edit ID [--title TITLE] [--content CONTENT] [--date \"dd.mm.yyyy hh:mm\"]\n");
+        return COMMAND_INVALID;
+    }
+    struct NoteNode *noteNode = findNoteNode(parseNoteKey(argv[1]));
+    if (noteNode == NULL)
+    {
+        fprintf(stderr, "Note %s not found\n", argv[1]);
+        return COMMAND_NOT_FOUND;
+    }
+    char *input = NULL;
+    if (content != NULL && strcmp(content, "-") == 0 && !batchMode)
+    {
+        content = input = readStandardInput();
+    }
+    const char *error = title == NULL ? NULL : titleValidator((void *)title);
+    error = error != NULL || content == NULL ? error : contentValidator((void *)content);
+    error = error != NULL || date == NULL ? error : dateValidator((void *)date);
+    if (error != NULL)
+    {
+        fprintf(stderr, "%s", error);
+        free(input);
+        return COMMAND_INVALID;
+    }
+    bool updated = updateNote(noteNode, title, content, date);
+    free(input);
+    if (!updated)
+    {
+        fprintf(stderr, "Cannot write %s\n", NOTES_JOURNAL_FILE);
+        return COMMAND_WRITE_FAILED;
+    }
+    return 0;
+}
+
+int deleteNoteCommand(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: delete ID...\n");
+        return COMMAND_INVALID;
+    }
+    int result = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (findNoteNode(parseNoteKey(argv[i])) == NULL)
+        {
+            fprintf(stderr, "Note %s not found\n", argv[i]);
+            result = COMMAND_NOT_FOUND;
+            continue;
+        }
+        if (!deleteNote(argv[i]))
+        {
+            fprintf(stderr, "Cannot write %s\n", NOTES_JOURNAL_FILE);
+            return COMMAND_WRITE_FAILED;
+        }
+    }
+    return result;
+}
+
+// Lists notes oldest first; --from and --to keep the ones between two dates.
+int listNotesCommand(int argc, char **argv)
+{
+    const char *from = getCommandOption(argc, argv, "from");
+    const char *to = getCommandOption(argc, argv, "to");
+    const char *error = from == NULL ? NULL : dateBoundValidator((void *)from);
+    error = error != NULL || to == NULL ? error : dateBoundValidator((void *)to);
+    if (error != NULL)
+    {
+        fprintf(stderr, "%s", error);
+        return COMMAND_INVALID;
+    }
+    buildDateIndex();
+    size_t start = from == NULL ? 0 : findDateIndexPosition(parseDate(from), 0);
+    size_t end = to == NULL ? dateIndexCount : findDateIndexPosition(parseDate(to) + 1, 0);
+    for (size_t position = start; position < end; position++)
+    {
+        printNoteRecord(dateIndex[position].noteNode->note);
+    }
+    return 0;
+}
+
+// Same query language as Search notes, best matches first.
+int queryNotesCommand(int argc, char **argv)
+{
+    const char *limitText = getCommandOption(argc, argv, "limit");
+    size_t limit = limitText != NULL ? strtoull(limitText, NULL, 10) : noteSlab.liveCount;
+    size_t length = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        length += strlen(argv[i]) + 1;
+    }
+    char *query = malloc(length);
+    query[0] = '\0';
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--limit") == 0)
+        {
+            i++;
+            continue;
+        }
+        strcat(query, argv[i]);
+        strcat(query, " ");
+    }
+    const char *error = searchQueryValidator(query);
+    if (error != NULL)
+    {
+        fprintf(stderr, "%s", error);
+        free(query);
+        return COMMAND_INVALID;
+    }
+    struct SearchResult *results;
+    size_t resultCount = searchNotes(query, &results, limit > 0 ? limit : 1);
+    if (resultCount > limit)
+    {
+        resultCount = limit;
+    }
+    for (size_t i = 0; i < resultCount; i++)
+    {
+        printNoteRecord(findNoteNode(results[i].id)->note);
+    }
+    free(results);
+    free(query);
+    return 0;
+}
+
+// Every change of the batch is written to the journal as it runs, but the
+// journal is synced and compacted once at the end.
+int batchCommand()
+{
+    batchMode = true;
+    int result = 0;
+    char *line = NULL;
+    size_t size = 0;
+    ssize_t length;
+    while ((length = getline(&line, &size, stdin)) != -1)
+    {
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+        {
+            line[--length] = '\0';
+        }
+        char *arguments[COMMAND_ARGUMENT_LIMIT];
+        int count = 0;
+        for (char *argument = line; argument != NULL && count < COMMAND_ARGUMENT_LIMIT; count++)
+        {
+            arguments[count] = argument;
+            argument = strchr(argument, '\t');
+            if (argument != NULL)
+            {
+                *argument++ = '\0';
+            }
+        }
+        if (length == 0)
+        {
+            continue;
+        }
+        int commandResult = runCommand(count, arguments);
+        result = commandResult > result ? commandResult : result;
+    }
+    free(line);
+    batchMode = false;
+    if (journalFile != NULL && SYNC_FILE(journalFile) != 0)
+    {
+        fprintf(stderr, "Cannot write %s\n", NOTES_JOURNAL_FILE);
+        result = COMMAND_WRITE_FAILED;
+    }
+    compactNotesIfNeeded();
+    return result;
+}
+
+// Streams notes out as JSON Lines or CSV:
+//   export [--format jsonl|csv] [--from D] [--to D] [--search TEXT] [--output FILE]
+// Notes are written in list order through one reused buffer, so exporting
+// needs the same memory for any number of notes. --search keeps the notes
+// whose title or content contains TEXT, ignoring case. Without --output, or
+// with --output -, the notes go to standard output; a file is written next
+// to its final name and renamed into place once complete. The format follows
+// the output extension unless --format is given, and both formats can be
+// imported again.
+int exportNotesCommand(int argc, char **argv)
+{
+    const char *format = getCommandOption(argc, argv, "format");
+    const char *from = getCommandOption(argc, argv, "from");
+    const char *to = getCommandOption(argc, argv, "to");
+    const char *search = getCommandOption(argc, argv, "search");
+    const char *path = getCommandOption(argc, argv, "output");
+    if (path != NULL && strcmp(path, "-") == 0)
+    {
+        path = NULL;
+    }
+    if (format == NULL)
+    {
+        const char *extension = path != NULL ? strrchr(path, '.') : NULL;
+        format = extension != NULL && strcmp(extension, ".csv") == 0 ? "csv" : "jsonl";
+    }
+    if ((strcmp(format, "csv") != 0 && strcmp(format, "jsonl") != 0) || (search != NULL && search[0] == '\0'))
+    {
+        fprintf(stderr, "Usage: export [--format jsonl|csv] [--from DATE] [--to DATE] [--search TEXT] [--output FILE]\n");
+        return COMMAND_INVALID;
+    }
+    const char *error = from == NULL ? NULL : dateBoundValidator((void *)from);
+    error = error != NULL || to == NULL ? error : dateBoundValidator((void *)to);
+    if (error != NULL)
+    {
+        fprintf(stderr, "%s", error);
+        return COMMAND_INVALID;
+    }
+    int32_t fromTimestamp = from != NULL ? parseDate(from) : INT32_MIN;
+    int32_t toTimestamp = to != NULL ? parseDate(to) : INT32_MAX;
+    bool json = strcmp(format, "jsonl") == 0;
+    size_t searchLength = search != NULL ? strlen(search) : 0;
+
+    char *tempPath = NULL;
+    FILE *file = stdout;
+    if (path != NULL)
+    {
+        tempPath = malloc(strlen(path) + 5);
+        sprintf(tempPath, "%s.tmp", path);
+        file = fopen(tempPath, "wb");
+        if (file == NULL)
+        {
+            fprintf(stderr, "Cannot write %s\n", path);
+            free(tempPath);
+            return COMMAND_WRITE_FAILED;
+        }
+    }
+    struct OutputBuffer output = {file, exportBuffer, sizeof(exportBuffer), 0, false};
+    if (!json)
+    {
+        writeOutput(&output, "title,content,date\n", 19);
+    }
+    for (struct NoteNode *current = notesList; current != NULL; current = current->next)
+    {
+        const struct Note *note = current->note;
+        if (note->timestamp < fromTimestamp || note->timestamp > toTimestamp)
+        {
+            continue;
+        }
+        if (search != NULL && findPattern(note->title, note->title + strlen(note->title), search, searchLength, true) == NULL &&
+            findPattern(note->content, note->content + strlen(note->content), search, searchLength, true) == NULL)
+        {
+            continue;
+        }
+        writeExportRecord(&output, note, json);
+    }
+    flushOutput(&output);
+
+    bool written = !output.failed;
+    if (path == NULL)
+    {
+        written = fflush(stdout) == 0 && written;
+    }
+    else if (written)
+    {
+        written = commitTempFile(file, tempPath, path);
+    }
+    else
+    {
+        fclose(file);
+        remove(tempPath);
+    }
+    free(tempPath);
+    if (!written)
+    {
+        fprintf(stderr, "Cannot write %s\n", path != NULL ? path : "the notes");
+        return COMMAND_WRITE_FAILED;
+    }
+    return 0;
+}
+
+void writeExportRecord(struct OutputBuffer *output, const struct Note *note, bool json)
+{
+    char date[17];
+    formatDate(note->timestamp, date);
+    date[10] = ' ';
+    formatTime(note->timestamp, date + 11);
+    if (!json)
+    {
+        writeCsvField(output, note->title);
+        writeOutput(output, ",", 1);
+        writeCsvField(output, note->content);
+        writeOutput(output, ",", 1);
+        writeOutput(output, date, 16);
+        writeOutput(output, "\n", 1);
+        return;
+    }
+    // ids are written as strings, they do not all fit a double
+    char id[64];
+    int idLength = snprintf(id, sizeof(id), "{\"id\": \"%llu\", \"title\": ", (unsigned long long)note->id);
+    writeOutput(output, id, idLength);
+    writeJsonString(output, note->title);
+    writeOutput(output, ", \"content\": ", 13);
+    writeJsonString(output, note->content);
+    writeOutput(output, ", \"date\": \"", 11);
+    writeOutput(output, date, 16);
+    writeOutput(output, "\"}\n", 3);
+}
+
+// Fields are only quoted when they hold a comma, a quote or a line break.
+void writeCsvField(struct OutputBuffer *output, const char *text)
+{
+    if (strpbrk(text, ",\"\r\n") == NULL)
+    {
+        writeOutput(output, text, strlen(text));
+        return;
+    }
+    writeOutput(output, "\"", 1);
+    for (const char *quote; (quote = strchr(text, '"')) != NULL; text = quote + 1)
+    {
+        writeOutput(output, text, quote + 1 - text);
+        writeOutput(output, "\"", 1);
+    }
+    writeOutput(output, text, strlen(text));
+    writeOutput(output, "\"", 1);
+}
+
+// Text without quotes, backslashes or control characters is copied in runs.
+void writeJsonString(struct OutputBuffer *output, const char *text)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    writeOutput(output, "\"", 1);
+    while (*text != '\0')
+    {
+        const char *run = text;
+        while (*text != '\0' && *text != '"' && *text != '\\' && (unsigned char)*text >= 0x20)
+        {
+            text++;
+        }
+        writeOutput(output, run, text - run);
+        if (*text == '\0')
+        {
+            break;
+        }
+        char escape[6] = {'\\', *text, '0', '0', '0', '0'};
+        size_t escapeLength = 2;
+        switch (*text)
+        {
+        case '\n':
+            escape[1] = 'n';
+            break;
+        case '\r':
+            escape[1] = 'r';
+            break;
+        case '\t':
+            escape[1] = 't';
+            break;
+        case '"':
+        case '\\':
+            break;
+        default:
+            escape[1] = 'u';
+            escape[4] = hexDigits[(unsigned char)*text >> 4];
+            escape[5] = hexDigits[*text & 0xf];
+            escapeLength = 6;
+        }
+        writeOutput(output, escape, escapeLength);
+        text++;
+    }
+    writeOutput(output, "\"", 1);
+}
+
+void writeOutput(struct OutputBuffer *output, const char *text, size_t length)
+{
+    if (output->length + length > output->size)
+    {
+        flushOutput(output);
+    }
+    if (length > output->size)
+    {
+        output->failed = output->failed || fwrite(text, 1, length, output->file) != length;
+        return;
+    }
+    memcpy(output->data + output->length, text, length);
+    output->length += length;
+}
+
+void flushOutput(struct OutputBuffer *output)
+{
+    if (output->length > 0 && fwrite(output->data, 1, output->length, output->file) != output->length)
+    {
+        output->failed = true;
+    }
+    output->length = 0;
+}
+
+// Imports a CSV or JSON Lines file in one go:
+//   import FILE [--format csv|jsonl] [--skip-invalid]
+// CSV rows are title,content[,date], with an optional header row and fields
+// quoted as in RFC 4180. JSON lines are objects with "title", "content" and
+// an optional "date" string. The format follows the file extension unless
+// --format is given. The file is cut at record boundaries into one chunk per
+// worker thread; the records are checked with the same validators as the
+// prompts, get consecutive ids and are written out with a single snapshot.
+// Nothing is imported when a record is invalid, unless --skip-invalid is
+// given.
+int importNotesCommand(int argc, char **argv)
+{
+    const char *format = getCommandOption(argc, argv, "format");
+    bool skipInvalid = false;
+    for (int i = 2; i < argc; i++)
+    {
+        skipInvalid = skipInvalid || strcmp(argv[i], "--skip-invalid") == 0;
+    }
+    if (argc >= 2 && format == NULL)
+    {
+        const char *extension = strrchr(argv[1], '.');
+        format = extension != NULL && (strcmp(extension, ".jsonl") == 0 || strcmp(extension, ".json") == 0) ? "jsonl" : "csv";
+    }
+    if (argc < 2 || strncmp(argv[1], "--", 2) == 0 || (strcmp(format, "csv") != 0 && strcmp(format, "jsonl") != 0))
+    {
+        fprintf(stderr, "Usage: import FILE [--format csv|jsonl] [--skip-invalid]\n");
+        return COMMAND_INVALID;
+    }
+    size_t size = 0;
+    char *data = mapFile(argv[1], &size);
+    if (data == NULL)
+    {
+        FILE *file = fopen(argv[1], "rb");
+        if (file == NULL)
+        {
+            fprintf(stderr, "Cannot read %s\n", argv[1]);
+            return COMMAND_INVALID;
+        }
+        fclose(file);
+        printf("0\n");
+        return 0;
+    }
+
+    size_t workerCount = getProcessorCount();
+    if (workerCount > size / IMPORT_MIN_CHUNK_SIZE + 1)
+    {
+        workerCount = size / IMPORT_MIN_CHUNK_SIZE + 1;
+    }
+    if (workerCount > IMPORT_WORKER_LIMIT)
+    {
+        workerCount = IMPORT_WORKER_LIMIT;
+    }
+    struct ImportChunk chunks[IMPORT_WORKER_LIMIT];
+    THREAD_HANDLE threads[IMPORT_WORKER_LIMIT];
+    bool started[IMPORT_WORKER_LIMIT];
+    const char *end = data + size;
+    const char *start = data;
+    int32_t now = currentTimestamp();
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        struct ImportChunk *chunk = &chunks[i];
+        memset(chunk, 0, sizeof(struct ImportChunk));
+        chunk->start = start;
+        chunk->end = i + 1 == workerCount ? end : findImportBoundary(start, data + size / workerCount * (i + 1), end, strcmp(format, "jsonl") == 0);
+        chunk->json = strcmp(format, "jsonl") == 0;
+        chunk->header = i == 0;
+        chunk->defaultTimestamp = now;
+        start = chunk->end;
+    }
+    // the first chunk is parsed here while the workers take the others
+    for (size_t i = 1; i < workerCount; i++)
+    {
+        started[i] = START_THREAD(&threads[i], importWorker, &chunks[i]);
+    }
+    parseImportChunk(&chunks[0]);
+    for (size_t i = 1; i < workerCount; i++)
+    {
+        if (started[i])
+        {
+            JOIN_THREAD(threads[i]);
+        }
+        else
+        {
+            parseImportChunk(&chunks[i]);
+        }
+    }
+
+    size_t recordCount = 0;
+    size_t errorCount = 0;
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        recordCount += chunks[i].recordCount;
+        errorCount += chunks[i].errorCount;
+    }
+    if (errorCount > 0)
+    {
+        reportImportErrors(data, chunks, workerCount, errorCount);
+    }
+    bool importing = recordCount > 0 && (errorCount == 0 || skipInvalid);
+    if (importing)
+    {
+        reserveNoteIndex(noteIndexCount + recordCount);
+        slabReserve(&noteSlab, recordCount);
+        slabReserve(&noteNodeSlab, recordCount);
+    }
+    uint64_t id = importing ? reserveNoteIds(recordCount) : 0;
+    for (size_t i = 0; i < workerCount; i++)
+    {
+        for (size_t index = 0; importing && index < chunks[i].recordCount; index++)
+        {
+            struct Note *note = slabAllocate(&noteSlab);
+            note->id = id++;
+            note->title = chunks[i].records[index].title;
+            note->content = chunks[i].records[index].content;
+            note->timestamp = chunks[i].records[index].timestamp;
+            note->menuItem = NULL;
+            linkNoteNode(note);
+        }
+        if (importing)
+        {
+            mergeArena(&stringArena, &chunks[i].strings);
+        }
+        freeArena(&chunks[i].strings);
+        free(chunks[i].records);
+        free(chunks[i].errors);
+    }
+    unmapFile(data, size);
+    if (errorCount > 0 && !skipInvalid)
     {
-        CLEAR_SCREEN();
-        printf("%s", getTranslation("noNotesFound", true));
-        PAUSE();
-        return;
+        return COMMAND_INVALID;
     }
-    const struct NoteNode *currentNoteNode = notesList;
-    struct MenuItem **menuItems = malloc(sizeof(struct MenuItem *));
-    int menuItemsCount = 0;
-    while (currentNoteNode != NULL)
+    if (importing && !compactNotes())
     {
-        currentNoteNode->note->menuItem->action = deleteNote;
-        currentNoteNode->note->menuItem->getTranslation = false;
-        menuItems[menuItemsCount] = currentNoteNode->note->menuItem;
-        menuItemsCount++;
-        menuItems = realloc(menuItems, (menuItemsCount + 1) * sizeof(struct MenuItem *));
-        currentNoteNode = currentNoteNode->next;
+        fprintf(stderr, "Cannot write %s\n", NOTES_BINARY_FILE);
+        return COMMAND_WRITE_FAILED;
     }
-    menuItems = realloc(menuItems, (menuItemsCount + 2) * sizeof(struct MenuItem *));
-    struct MenuItem *backMenuItem = malloc(sizeof(struct MenuItem));
-    backMenuItem->title = NULL;
-    backMenuItem->key = "back";
-    backMenuItem->action = back;
-    backMenuItem->getTranslation = true;
-    menuItems[menuItemsCount] = backMenuItem;
-    menuItems[menuItemsCount + 1] = NULL;
-    showMenu(menuItems, "deleteNoteActionTitle", "deleteNoteActionIndication");
+    printf("%zu\n", importing ? recordCount : 0);
+    return 0;
 }
 
-bool stayInMenu(char *key)
+#ifdef _WIN32
+DWORD WINAPI importWorker(LPVOID chunk)
+#else
+void *importWorker(void *chunk)
+#endif
 {
-    return strstr(key, "Action") != NULL;
-    // modified without testing
-    // TODO: test
+    parseImportChunk(chunk);
+    return 0;
 }
 
-void showMenu(struct MenuItem **menuItems, char *titleTranslationKey, char *instructionsTranslationKey)
+size_t getProcessorCount()
 {
-    static int selectedItem;
-    int menuItemsCount = getMenuItemCount(menuItems);
-    char *title = getTranslation(titleTranslationKey, false);
-    char *instructions = getTranslation(instructionsTranslationKey, false);
-    if (selectedItem > menuItemsCount - 1)
-    {
-        selectedItem = 0;
-    }
-    if (selectedItem < 0)
+#ifdef _WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    return systemInfo.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? count : 1;
+#endif
+}
+
+// The first record start at or after target. Quoted CSV fields may hold line
+// breaks, so the quotes are counted from start, which begins a record.
+const char *findImportBoundary(const char *start, const char *target, const char *end, bool json)
+{
+    bool quoted = false;
+    const char *position = json && target > start ? target : start;
+    for (; !json && position < target; position++)
     {
-        selectedItem = menuItemsCount - 1;
+        quoted ^= *position == '"';
     }
-    CLEAR_SCREEN();
-    title != NULL ? printf("---- %s ----\n", title) : printf("---- %s ----\n", getTranslation("firstMenuTitle", false));
-    for (int index = 0; index < menuItemsCount; index++)
+    for (; position < end; position++)
     {
-        if (menuItems[index]->getTranslation)
-            menuItems[index]->title = getTranslation(menuItems[index]->key, false);
-        index == selectedItem ? printf(" >> %s << \n", menuItems[index]->title) : printf(" > %s < \n", menuItems[index]->title);
+        if (*position == '"' && !json)
+        {
+            quoted = !quoted;
+        }
+        else if (*position == '\n' && !quoted)
+        {
+            return position + 1;
+        }
     }
-    instructions != NULL ? printf("%s", instructions) : printf("%s", getTranslation("firstMenuIndication", false));
-    handleMenuInput(menuItems, &selectedItem, menuItems[selectedItem]->action, titleTranslationKey, instructionsTranslationKey);
+    return end;
 }
 
-void handleMenuInput(struct MenuItem **menuItems, int *selectedItem, void (*action)(void *data), char *title, char *instructions)
+// Errors are kept with the record they belong to, so their line numbers are
+// only counted here, for the few that are printed.
+void reportImportErrors(const char *data, const struct ImportChunk *chunks, size_t chunkCount, size_t errorCount)
 {
-    while (1)
+    size_t line = 1;
+    size_t reported = 0;
+    const char *counted = data;
+    for (size_t i = 0; i < chunkCount && reported < IMPORT_ERROR_REPORT_LIMIT; i++)
     {
-        char input;
-        input = GET_KEY();
-        if (input == 'w' || input == 'W')
+        for (size_t index = 0; index < chunks[i].errorCount && reported < IMPORT_ERROR_REPORT_LIMIT; index++, reported++)
         {
-            *selectedItem -= 1;
-            break;
+            const struct ImportError *error = &chunks[i].errors[index];
+            for (; counted < error->record; counted++)
+            {
+                line += *counted == '\n';
+            }
+            fprintf(stderr, "Line %zu: %s", line, error->message);
         }
-        if (input == 's' || input == 'S')
+    }
+    if (errorCount > reported)
+    {
+        fprintf(stderr, "%zu more invalid records\n", errorCount - reported);
+    }
+}
+
+void parseImportChunk(struct ImportChunk *chunk)
+{
+    const char *position = chunk->start;
+    while (position < chunk->end)
+    {
+        const char *record = position;
+        char *fields[3] = {NULL, NULL, NULL};
+        const char *error = chunk->json ? parseJsonRecord(chunk, &position, fields) : parseCsvRecord(chunk, &position, fields);
+        if (error == NULL && fields[0] == NULL && fields[1] == NULL && fields[2] == NULL)
         {
-            *selectedItem += 1;
-            break;
+            continue;
         }
-        if (input == 'e' || input == 'E')
+        if (chunk->header)
         {
-            int itemIndex = *selectedItem;
-            *selectedItem = 0;
-            action(menuItems[itemIndex]->key);
-            *selectedItem = itemIndex;
-            if (stayInMenu(menuItems[itemIndex]->key))
+            chunk->header = false;
+            if (!chunk->json && error == NULL && fields[0] != NULL && strlen(fields[0]) == 5 && matchesPattern(fields[0], "title", 5, true))
             {
-                break;
+                continue;
             }
-            else
+        }
+        error = error != NULL ? error : titleValidator(fields[0] != NULL ? fields[0] : "");
+        error = error != NULL ? error : contentValidator(fields[1] != NULL ? fields[1] : "");
+        error = error != NULL || fields[2] == NULL ? error : dateValidator(fields[2]);
+        if (error != NULL)
+        {
+            if (chunk->errorCount == chunk->errorCapacity)
             {
-                return;
-                freeMenuItems(menuItems);
+                chunk->errorCapacity = chunk->errorCapacity == 0 ? 16 : chunk->errorCapacity * 2;
+                chunk->errors = realloc(chunk->errors, chunk->errorCapacity * sizeof(struct ImportError));
             }
+            chunk->errors[chunk->errorCount].record = record;
+            chunk->errors[chunk->errorCount].message = error;
+            chunk->errorCount++;
+            continue;
         }
+        if (chunk->recordCount == chunk->recordCapacity)
+        {
+            chunk->recordCapacity = chunk->recordCapacity == 0 ? 1024 : chunk->recordCapacity * 2;
+            chunk->records = realloc(chunk->records, chunk->recordCapacity * sizeof(struct ImportRecord));
+        }
+        chunk->records[chunk->recordCount].title = fields[0];
+        chunk->records[chunk->recordCount].content = fields[1];
+        chunk->records[chunk->recordCount].timestamp = fields[2] != NULL ? parseDate(fields[2]) : chunk->defaultTimestamp;
+        chunk->recordCount++;
     }
-    showMenu(menuItems, title, instructions);
 }
 
-void initializeFirstItems(struct MenuItem **menuItems)
+// The position after the next line break, or end.
+const char *skipLine(const char *position, const char *end)
 {
-    struct MenuItem *addNotesMenuItem = malloc(sizeof(struct MenuItem));
-    addNotesMenuItem->key = "addNoteAction";
-    addNotesMenuItem->title = NULL;
-    addNotesMenuItem->action = addNoteAction;
-    addNotesMenuItem->getTranslation = true;
-    menuItems[0] = addNotesMenuItem;
-
-    struct MenuItem *deleteNotesMenuItem = malloc(sizeof(struct MenuItem));
-    deleteNotesMenuItem->key = "deleteNoteAction";
-    deleteNotesMenuItem->title = NULL;
-    deleteNotesMenuItem->action = deleteNoteAction;
-    deleteNotesMenuItem->getTranslation = true;
-    menuItems[1] = deleteNotesMenuItem;
-
-    struct MenuItem *editNotesMenuItem = malloc(sizeof(struct MenuItem));
-    editNotesMenuItem->key = "editNoteAction";
-    editNotesMenuItem->title = NULL;
-    editNotesMenuItem->action = editNoteAction;
-    editNotesMenuItem->getTranslation = true;
-    menuItems[2] = editNotesMenuItem;
-
-    struct MenuItem *viewNotesMenuItem = malloc(sizeof(struct MenuItem));
-    viewNotesMenuItem->key = "viewNotes";
-    viewNotesMenuItem->title = NULL;
-    viewNotesMenuItem->action = viewNotes;
-    viewNotesMenuItem->getTranslation = true;
-    menuItems[3] = viewNotesMenuItem;
-
-    struct MenuItem *viewNotesMenuItemByDate = malloc(sizeof(struct MenuItem));
-    viewNotesMenuItemByDate->key = "viewNotesByDate";
-    viewNotesMenuItemByDate->title = NULL;
-    viewNotesMenuItemByDate->action = viewNotesByDate;
-    viewNotesMenuItemByDate->getTranslation = true;
-    menuItems[4] = viewNotesMenuItemByDate;
-
-    struct MenuItem *settingsMenuItem = malloc(sizeof(struct MenuItem));
-    settingsMenuItem->key = "settingsAction";
-    settingsMenuItem->title = NULL;
-    settingsMenuItem->action = settingsAction;
-    settingsMenuItem->getTranslation = true;
-    menuItems[5] = settingsMenuItem;
-
-    struct MenuItem *exitMenuItem = malloc(sizeof(struct MenuItem));
-    exitMenuItem->key = "exit";
-    exitMenuItem->title = NULL;
-    exitMenuItem->action = exitApp;
-    exitMenuItem->getTranslation = true;
-    menuItems[6] = exitMenuItem;
+    const char *lineEnd = memchr(position, '\n', end - position);
+    return lineEnd != NULL ? lineEnd + 1 : end;
+}
 
-    menuItems[7] = NULL;
+// Reads one CSV row into title, content and date. A blank line leaves every
+// field NULL.
+const char *parseCsvRecord(struct ImportChunk *chunk, const char **position, char **fields)
+{
+    const char *end = chunk->end;
+    const char *current = *position;
+    int count = 0;
+    if (*current == '\n' || (*current == '\r' && (current + 1 == end || current[1] == '\n')))
+    {
+        *position = skipLine(current, end);
+        return NULL;
+    }
+    while (true)
+    {
+        char *field;
+        const char *error = parseCsvField(chunk, &current, &field);
+        if (error != NULL)
+        {
+            *position = skipLine(current, end);
+            return error;
+        }
+        if (count < 3)
+        {
+            fields[count] = field;
+        }
+        count++;
+        if (current == end || *current != ',')
+        {
+            break;
+        }
+        current++;
+    }
+    *position = skipLine(current, end);
+    return count > 3 ? "A record has a title, a content and an optional date! \n" : NULL;
 }
 
-void initializeNotesList()
+// Leaves position on the comma or line break that ends the field.
+const char *parseCsvField(struct ImportChunk *chunk, const char **position, char **field)
 {
-    FILE *file = fopen("notes.txt", "r");
-    if (file == NULL)
+    const char *end = chunk->end;
+    const char *start = *position;
+    const char *current = start;
+    if (current < end && *current == '"')
     {
-        return;
+        bool escaped = false;
+        start = ++current;
+        while (true)
+        {
+            const char *quote = memchr(current, '"', end - current);
+            if (quote == NULL)
+            {
+                *position = end;
+                return "A quoted field is not closed! \n";
+            }
+            current = quote + 1;
+            if (current == end || *current != '"')
+            {
+                break;
+            }
+            escaped = true;
+            current++;
+        }
+        size_t length = current - 1 - start;
+        char *text = arenaAllocate(&chunk->strings, length + 1, 1);
+        if (!escaped)
+        {
+            memcpy(text, start, length);
+        }
+        else
+        {
+            // "" stands for one quote
+            length = 0;
+            for (const char *character = start; character < current - 1; character++)
+            {
+                text[length++] = *character;
+                character += *character == '"';
+            }
+        }
+        text[length] = '\0';
+        *field = text;
+        if (current < end && *current == '\r')
+        {
+            current++;
+        }
+        *position = current;
+        if (current < end && *current != ',' && *current != '\n')
+        {
+            return "Text after a quoted field! \n";
+        }
+        return NULL;
     }
-    char *line = malloc(sizeof(char) * config->MAX_CONTENT_LENGTH);
-    size_t len = 0;
-    if (getFileSize(file) == 0)
+    while (current < end && *current != ',' && *current != '\n')
     {
-        return;
+        current++;
     }
-    while (getline(&line, &len, file) != -1)
+    *position = current;
+    if (current > start && current[-1] == '\r' && (current == end || *current == '\n'))
     {
-        char *key = strtok(line, "|");
-        char *title = strtok(NULL, "|");
-        char *content = strtok(NULL, "|");
-        char *day = strtok(NULL, "|");
-        char *month = strtok(NULL, "|");
-        char *year = strtok(NULL, "|");
-        char *hour = strtok(NULL, "|");
-        char *minute = strtok(NULL, "|");
-
-        struct Note *note = malloc(sizeof(struct Note));
-        note->title = title;
-        note->content = content;
-        note->date.day = atoi(day);
-        note->date.month = atoi(month);
-        note->date.year = atoi(year);
-        note->date.hour = atoi(hour);
-        note->date.minute = atoi(minute);
-        note->menuItem = malloc(sizeof(struct MenuItem));
-        note->menuItem->key = key;
-        char *menuTitle = malloc(sizeof(char *) * (config->MAX_TITLE_LENGTH + config->MAX_DATE_LENGTH));
-        sprintf(menuTitle, "%s - %s", note->title, formatDate(note->date.day, note->date.month, note->date.year));
-        note->menuItem->title = menuTitle;
-        note->menuItem->action = NULL;
-        addNoteToList(note);
+        current--;
     }
-    free(line);
-    fclose(file);
+    *field = arenaAllocate(&chunk->strings, current - start + 1, 1);
+    memcpy(*field, start, current - start);
+    (*field)[current - start] = '\0';
+    return NULL;
 }
 
-void initConfig()
+// Reads one JSON object per line, taking its "title", "content" and "date"
+// strings and skipping any other member. A blank line leaves every field
+// NULL.
+const char *parseJsonRecord(struct ImportChunk *chunk, const char **position, char **fields)
 {
-    FILE *file = fopen("config.txt", "r");
-    config = malloc(sizeof(struct Config));
-    char *line = malloc(sizeof(char) * config->MAX_CONTENT_LENGTH);
-    size_t len = 0;
-    if (file == NULL || getFileSize(file) == 0)
+    static const char *const names[3] = {"title", "content", "date"};
+    const char *malformed = "Not a JSON object! \n";
+    const char *lineEnd = memchr(*position, '\n', chunk->end - *position);
+    lineEnd = lineEnd != NULL ? lineEnd : chunk->end;
+    const char *current = skipJsonSpace(*position, lineEnd);
+    *position = lineEnd < chunk->end ? lineEnd + 1 : lineEnd;
+    if (current == lineEnd)
     {
-        config->MAX_TITLE_LENGTH = 100;
-        config->MAX_CONTENT_LENGTH = 1000;
-        config->MAX_DATE_LENGTH = 20;
-        config->MAX_MESSAGE_LENGTH = 100;
-        config->MAX_NOTES_COUNT = 100;
-        config->color = WHITE;
-        config->language = ENGLISH;
-        saveConfig();
-        return;
+        return NULL;
     }
-    while (getline(&line, &len, file) != -1)
+    if (*current != '{')
     {
-        char *key = strtok(line, "|");
-        char *value = strtok(NULL, "|");
-        if (strcmp(key, "maxTitleLength") == 0)
+        return malformed;
+    }
+    current = skipJsonSpace(current + 1, lineEnd);
+    while (current < lineEnd && *current != '}')
+    {
+        if (*current != '"')
         {
-            config->MAX_TITLE_LENGTH = atoi(value);
+            return malformed;
         }
-        if (strcmp(key, "maxContentLength") == 0)
+        const char *name = current + 1;
+        current = skipJsonValue(current, lineEnd);
+        if (current == NULL)
         {
-            config->MAX_CONTENT_LENGTH = atoi(value);
+            return malformed;
         }
-        if (strcmp(key, "maxDateLength") == 0)
+        size_t nameLength = current - 1 - name;
+        current = skipJsonSpace(current, lineEnd);
+        if (current == lineEnd || *current != ':')
         {
-            config->MAX_DATE_LENGTH = atoi(value);
+            return malformed;
         }
-        if (strcmp(key, "maxMessageLength") == 0)
+        current = skipJsonSpace(current + 1, lineEnd);
+        int field = 0;
+        while (field < 3 && (strlen(names[field]) != nameLength || memcmp(names[field], name, nameLength) != 0))
         {
-            config->MAX_MESSAGE_LENGTH = atoi(value);
+            field++;
         }
-        if (strcmp(key, "maxNotesCount") == 0)
+        if (field < 3)
         {
-            config->MAX_NOTES_COUNT = atoi(value);
+            if (current == lineEnd || *current != '"')
+            {
+                return "Title, content and date must be JSON strings! \n";
+            }
+            const char *error = parseJsonString(chunk, &current, lineEnd, &fields[field]);
+            if (error != NULL)
+            {
+                return error;
+            }
         }
-        if (strcmp(key, "color") == 0)
+        else if ((current = skipJsonValue(current, lineEnd)) == NULL)
         {
-            config->color = atoi(value);
+            return malformed;
         }
-        if (strcmp(key, "language") == 0)
+        current = skipJsonSpace(current, lineEnd);
+        if (current < lineEnd && *current == ',')
         {
-            config->language = atoi(value);
+            current = skipJsonSpace(current + 1, lineEnd);
+            if (current == lineEnd || *current == '}')
+            {
+                return malformed;
+            }
+        }
+        else if (current == lineEnd || *current != '}')
+        {
+            return malformed;
         }
     }
-    SET_COLOR(config->color);
-    free(line);
-    fclose(file);
+    if (current == lineEnd || skipJsonSpace(current + 1, lineEnd) != lineEnd)
+    {
+        return malformed;
+    }
+    return NULL;
 }
 
-char *addDynamicValueToString(char *str, char *value)
+// Unescapes the string that starts at position into the chunk's arena. The
+// text never grows, so it is given the length of the escaped string.
+const char *parseJsonString(struct ImportChunk *chunk, const char **position, const char *end, char **text)
 {
-    char *newStr = malloc(strlen(str) + strlen(value) + 1);
-    if (newStr == NULL)
-    {
-        return NULL;
-    }
-    char *p = strstr(str, "#value");
-    if (p == NULL)
+    const char *malformed = "Malformed JSON string! \n";
+    const char *start = *position + 1;
+    const char *current = start;
+    bool escaped = false;
+    while (current < end && *current != '"')
     {
-        strcpy(newStr, str);
+        escaped = escaped || *current == '\\';
+        current += *current == '\\' ? 2 : 1;
     }
-    else
+    if (current >= end)
     {
-        *p = '\0';
-        sprintf(newStr, "%s%s%s", str, value, p + strlen("#value"));
+        return malformed;
     }
-    str = realloc(str, strlen(newStr) + 1);
-    strcpy(str, newStr);
-    free(newStr);
-    return str;
-}
-
-void updateTranslations()
-{
-    FILE *file = fopen("translations.txt", "r");
-    char *line = malloc(sizeof(char) * config->MAX_CONTENT_LENGTH);
-    size_t len = 0;
-    if (file == NULL || getFileSize(file) == 0)
+    *position = current + 1;
+    char *copy = arenaAllocate(&chunk->strings, current - start + 1, 1);
+    *text = copy;
+    if (!escaped)
     {
-        return;
+        memcpy(copy, start, current - start);
+        copy[current - start] = '\0';
+        return NULL;
     }
-    while (getline(&line, &len, file) != -1)
+    static const char escapes[] = "\"\"\\\\//b\bf\fn\nr\rt\t";
+    size_t length = 0;
+    for (const char *character = start; character < current; character++)
     {
-        char *key = strtok(line, "|");
-        for (int i = 0; i < config->language; i++)
+        if (*character != '\\')
         {
-            strtok(NULL, "|");
+            copy[length++] = *character;
+            continue;
         }
-        char *value = strtok(NULL, "|");
-        const int valueLength = strlen(value);
-        if (value[valueLength - 1] == '\n')
+        character++;
+        // strchr would find the terminator of escapes for a NUL byte
+        const char *escape = *character == '\0' ? NULL : strchr(escapes, *character);
+        if (*character != 'u' && (escape == NULL || (escape - escapes) % 2 != 0))
         {
-            value[valueLength - 1] = '\0';
+            return malformed;
         }
-        struct TranslationNode *current = translations;
-        while (current != NULL)
+        if (*character != 'u')
         {
-            if (strcmp(current->key, key) == 0)
-            {
-                current->value = realloc(current->value, sizeof(char) * (valueLength + 1));
-                strcpy(current->value, value);
-                break;
-            }
-            current = current->next;
+            copy[length++] = escape[1];
+            continue;
+        }
+        uint32_t codePoint;
+        uint32_t low;
+        if (!readJsonHex(character + 1, current, &codePoint) || codePoint == 0)
+        {
+            return malformed;
+        }
+        character += 4;
+        if (codePoint >= 0xd800 && codePoint <= 0xdbff && current - character > 6 && character[1] == '\\' && character[2] == 'u' &&
+            readJsonHex(character + 3, current, &low) && low >= 0xdc00 && low <= 0xdfff)
+        {
+            codePoint = 0x10000 + ((codePoint - 0xd800) << 10) + (low - 0xdc00);
+            character += 6;
+        }
+        if (codePoint < 0x80)
+        {
+            copy[length++] = codePoint;
+        }
+        else if (codePoint < 0x800)
+        {
+            copy[length++] = 0xc0 | codePoint >> 6;
+            copy[length++] = 0x80 | (codePoint & 0x3f);
+        }
+        else if (codePoint < 0x10000)
+        {
+            copy[length++] = 0xe0 | codePoint >> 12;
+            copy[length++] = 0x80 | (codePoint >> 6 & 0x3f);
+            copy[length++] = 0x80 | (codePoint & 0x3f);
+        }
+        else
+        {
+            copy[length++] = 0xf0 | codePoint >> 18;
+            copy[length++] = 0x80 | (codePoint >> 12 & 0x3f);
+            copy[length++] = 0x80 | (codePoint >> 6 & 0x3f);
+            copy[length++] = 0x80 | (codePoint & 0x3f);
         }
     }
-    free(line);
-    fclose(file);
+    copy[length] = '\0';
+    return NULL;
 }
 
-void addTranslation(struct TranslationNode *translation)
+// Reads the four hex digits of a \u escape.
+bool readJsonHex(const char *text, const char *end, uint32_t *value)
 {
-    if (translations == NULL)
+    if (end - text < 4)
     {
-        translations = translation;
-        return;
+        return false;
     }
-    struct TranslationNode *current = translations;
-    while (current->next != NULL)
+    *value = 0;
+    for (int i = 0; i < 4; i++)
     {
-        current = current->next;
+        if (!isxdigit((unsigned char)text[i]))
+        {
+            return false;
+        }
+        *value = *value << 4 | (isdigit((unsigned char)text[i]) ? text[i] - '0' : tolower((unsigned char)text[i]) - 'a' + 10);
     }
-    current->next = translation;
+    return true;
 }
 
-char *getTranslation(const char *key, bool newLineAtEnd)
+// Steps over one value of any type, or returns NULL when it does not end
+// before end.
+const char *skipJsonValue(const char *position, const char *end)
 {
-    struct TranslationNode *current = translations;
-    while (current != NULL)
+    int depth = 0;
+    bool inString = false;
+    for (; position < end; position++)
     {
-        if (strcmp(current->key, key) == 0)
+        if (inString)
         {
-            char *value = malloc(sizeof(char) * (strlen(current->value) + 1));
-            strcpy(value, current->value);
-            if (newLineAtEnd && current->value[strlen(current->value) - 1] != '\n')
+            position += *position == '\\';
+            inString = *position != '"';
+            if (!inString && depth == 0)
             {
-                strcat(value, "\n");
+                return position + 1;
             }
-            return value;
         }
-        current = current->next;
+        else if (*position == '"')
+        {
+            inString = true;
+        }
+        else if (*position == '{' || *position == '[')
+        {
+            depth++;
+        }
+        else if (*position == '}' || *position == ']')
+        {
+            if (depth == 0)
+            {
+                return position;
+            }
+            if (--depth == 0)
+            {
+                return position + 1;
+            }
+        }
+        else if (depth == 0 && (*position == ',' || isspace((unsigned char)*position)))
+        {
+            return position;
+        }
     }
-    return "NOT FOUND, PLEASE ADD IT TO TRANSLATIONS FILE";
+    return inString || depth > 0 ? NULL : position;
 }
 
-void initTranslations()
+const char *skipJsonSpace(const char *position, const char *end)
 {
-    FILE *file = fopen("translations.txt", "r");
-    char *line = malloc(sizeof(char) * config->MAX_CONTENT_LENGTH);
-    size_t len = 0;
-    if (file == NULL || getFileSize(file) == 0)
-    {
-        printf("Translations file not found, WE WILL EXIT NOW");
-        PAUSE();
-        exitApp();
-    }
-    while (getline(&line, &len, file) != -1)
+    while (position < end && (*position == ' ' || *position == '\t' || *position == '\r'))
     {
-        char *key = strtok(line, "|");
-        for (int i = 0; i < config->language; i++)
-        {
-            strtok(NULL, "|");
-        }
-        char *value = strtok(NULL, "|");
-        const int valueLength = strlen(value);
-        if (value[valueLength - 1] == '\n')
-        {
-            value[valueLength - 1] = '\0';
-        }
-        struct TranslationNode *translation = malloc(sizeof(struct TranslationNode));
-        translation->key = malloc(strlen(key) + 1);
-        translation->value = malloc(strlen(value) + 1);
-        strcpy(translation->key, key);
-        strcpy(translation->value, value);
-        translation->next = NULL;
-        addTranslation(translation);
+        position++;
     }
-    free(line);
-    fclose(file);
+    return position;
 }
 
-int main()
+int main(int argc, char **argv)
 {
+    if (argc > 1)
+    {
+        initConfig();
+        initializeNotesList();
+        int result = runCommand(argc - 1, argv + 1);
+        fflush(stdout);
+        return result;
+    }
+    initScreen();
     initConfig();
+    setScreenColor(config->color);
     initTranslations();
     initializeNotesList();
-    struct MenuItem **firstMenuItems = malloc(sizeof(struct MenuItem *) * 8);
+    struct MenuItem **firstMenuItems = malloc(sizeof(struct MenuItem *) * 12);
     initializeFirstItems(firstMenuItems);
     while (TRUE)
     {
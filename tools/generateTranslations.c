@@ -0,0 +1,204 @@
+// Compiles translations.txt into translationsCatalog.h, the built-in
+// translation table included by main.c:
+//
+//     gcc tools/generateTranslations.c -o generateTranslations
+//     ./generateTranslations translations.txt translationsCatalog.h
+//
+// Every line of the input is key|language 0|language 1|...; an empty value
+// means the key falls back to English at run time.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+struct Translation
+{
+    char *key;
+    char **values;
+};
+
+// must match hashTranslationKey() in main.c
+uint64_t hashTranslationKey(const char *key)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (; *key != '\0'; key++)
+    {
+        hash ^= (unsigned char)*key;
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+void writeString(FILE *file, const char *text)
+{
+    if (text == NULL)
+    {
+        fprintf(file, "NULL");
+        return;
+    }
+    fputc('"', file);
+    for (; *text != '\0'; text++)
+    {
+        unsigned char c = *text;
+        if (c == '"' || c == '\\')
+        {
+            fprintf(file, "\\%c", c);
+        }
+        else if (c < 32 || c >= 127)
+        {
+            // octal escapes stop after three digits, unlike hex ones
+            fprintf(file, "\\%03o", c);
+        }
+        else
+        {
+            fputc(c, file);
+        }
+    }
+    fputc('"', file);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 3)
+    {
+        fprintf(stderr, "usage: %s translations.txt translationsCatalog.h\n", argv[0]);
+        return 1;
+    }
+    FILE *input = fopen(argv[1], "rb");
+    if (input == NULL)
+    {
+        fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    fseek(input, 0, SEEK_END);
+    long size = ftell(input);
+    fseek(input, 0, SEEK_SET);
+    char *text = malloc(size + 1);
+    size = fread(text, 1, size, input);
+    text[size] = '\0';
+    fclose(input);
+
+    int languageCount = 0;
+    int columns = 0;
+    size_t lineCount = 1;
+    for (const char *c = text; *c != '\0'; c++)
+    {
+        if (*c == '|')
+        {
+            columns++;
+        }
+        if (*c == '\n')
+        {
+            lineCount++;
+            columns = 0;
+        }
+        if (columns > languageCount)
+        {
+            languageCount = columns;
+        }
+    }
+
+    struct Translation *translations = calloc(lineCount, sizeof(struct Translation));
+    size_t translationCount = 0;
+    char *line = text;
+    while (*line != '\0')
+    {
+        char *end = strchr(line, '\n');
+        char *next = end == NULL ? line + strlen(line) : end + 1;
+        if (end != NULL)
+        {
+            *end = '\0';
+        }
+        char *field = strchr(line, '|');
+        if (field != NULL && field != line)
+        {
+            *field = '\0';
+            struct Translation *translation = NULL;
+            for (size_t i = 0; i < translationCount; i++)
+            {
+                if (strcmp(translations[i].key, line) == 0)
+                {
+                    translation = &translations[i];
+                }
+            }
+            if (translation == NULL)
+            {
+                translation = &translations[translationCount++];
+                translation->key = line;
+                translation->values = calloc(languageCount, sizeof(char *));
+            }
+            for (int column = 0; field != NULL; column++)
+            {
+                char *value = field + 1;
+                field = strchr(value, '|');
+                if (field != NULL)
+                {
+                    *field = '\0';
+                }
+                size_t length = strlen(value);
+                if (length > 0 && value[length - 1] == '\r')
+                {
+                    value[--length] = '\0';
+                }
+                if (length > 0)
+                {
+                    translation->values[column] = value;
+                }
+            }
+        }
+        line = next;
+    }
+
+    // same open addressing layout as the run time table, kept at most half full
+    size_t capacity = 16;
+    while (capacity < translationCount * 2)
+    {
+        capacity *= 2;
+    }
+    struct Translation **slots = calloc(capacity, sizeof(struct Translation *));
+    for (size_t i = 0; i < translationCount; i++)
+    {
+        size_t slot = hashTranslationKey(translations[i].key) & (capacity - 1);
+        while (slots[slot] != NULL)
+        {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        slots[slot] = &translations[i];
+    }
+
+    FILE *output = fopen(argv[2], "wb");
+    if (output == NULL)
+    {
+        fprintf(stderr, "cannot write %s\n", argv[2]);
+        return 1;
+    }
+    fprintf(output, "// Generated from translations.txt by tools/generateTranslations.c, do not edit.\n\n");
+    fprintf(output, "#define BUILTIN_TRANSLATION_LANGUAGE_COUNT %d\n", languageCount);
+    fprintf(output, "#define BUILTIN_TRANSLATION_CAPACITY %zu\n\n", capacity);
+    fprintf(output, "static const struct BuiltinTranslation\n{\n    const char *key;\n    const char *values[BUILTIN_TRANSLATION_LANGUAGE_COUNT];\n} builtinTranslations[BUILTIN_TRANSLATION_CAPACITY] = {\n");
+    for (size_t slot = 0; slot < capacity; slot++)
+    {
+        if (slots[slot] == NULL)
+        {
+            fprintf(output, "    {NULL, {NULL}},\n");
+            continue;
+        }
+        fprintf(output, "    {");
+        writeString(output, slots[slot]->key);
+        fprintf(output, ", {");
+        for (int column = 0; column < languageCount; column++)
+        {
+            fprintf(output, column == 0 ? "" : ", ");
+            writeString(output, slots[slot]->values[column]);
+        }
+        fprintf(output, "}},\n");
+    }
+    fprintf(output, "};\n");
+    if (fclose(output) != 0)
+    {
+        fprintf(stderr, "cannot write %s\n", argv[2]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,267 @@
+// Generated from translations.txt by tools/generateTranslations.c, do not edit.
+
+#define BUILTIN_TRANSLATION_LANGUAGE_COUNT 3
+#define BUILTIN_TRANSLATION_CAPACITY 256
+
+static const struct BuiltinTranslation
+{
+    const char *key;
+    const char *values[BUILTIN_TRANSLATION_LANGUAGE_COUNT];
+} builtinTranslations[BUILTIN_TRANSLATION_CAPACITY] = {
+    {"firstMenuIndication", {"Use w and s to navigate, press e to select", "Foloseste w si s pentru a naviga, apasa e pentru a selecta actiunea dorita", "Use w and s to navigate, press e to select"}},
+    {"viewLatestNotes", {"View latest notes", "Vizualizati ultimele notite", "Ver las ultimas notas"}},
+    {"back", {"Back", "Inapoi", "Atras"}},
+    {"viewNotesIndication", {"Use w and s to scroll, a and d to change page, g to go to a number, / to filter by title, press e to go back", "Foloseste w si s pentru a derula, a si d pentru a schimba pagina, g pentru a merge la un numar, / pentru a filtra dupa titlu, apasa e pentru a reveni", "Use w y s para desplazarse, a y d para cambiar de pagina, g para ir a un numero, / para filtrar por titulo, presione e para volver"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"12", {"Red", "Rosu", "Rojo"}},
+    {"editNoteAction", {"Edit note", "Editati notita", "Editar nota"}},
+    {"statsStringBytes", {"Text heap used / reserved (bytes)", "Text folosit / rezervat (octeti)", "Texto usado / reservado (bytes)"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"statsMappedBytes", {"Mapped notes.bin (bytes)", "notes.bin mapat (octeti)", "notes.bin mapeado (bytes)"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"2", {"Spanish", "Spaniola", "Espanol"}},
+    {NULL, {NULL}},
+    {"changeLanguageActionIndication", {"Please select a language", "Te rog selecteaza o limba", "Por favor seleccione un idioma"}},
+    {NULL, {NULL}},
+    {"editNoteActionIndication", {"Select note to edit, Select 'back' to go back ", " Selectati notita pentru a o edita, Selectati 'inapoi' pentru a reveni inapoi", "Seleccione nota para editar, Seleccione 'atras' para volver"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"changeColorActionTitle", {"Change Color", "Schimba Culoarea", "Cambiar color"}},
+    {NULL, {NULL}},
+    {"deleteNoteActionIndication", {"Select note to delete, Select 'back' to go back ", " Selectati notita pentru a o sterge, Selectati 'inapoi' pentru a reveni inapoi", "Seleccione nota para borrar, Seleccione 'atras' para volver"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"title", {"Title: #title", "Titlu #title", "Titulo #title"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"getInputSearchQuery", {"Enter the words to search for (use OR between alternatives)", "introdu cuvintele cautate (folositi OR intre alternative)", "introduzca las palabras a buscar (use OR entre alternativas)"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"searchResultsCount", {"#count notes found", "#count notite gasite", "#count notas encontradas"}},
+    {"date", {"Date #date", "Data #date", "Fecha #date"}},
+    {"exportNotesAction", {"Export notes to text", "Exportati notitele ca text", "Exportar notas a texto"}},
+    {"grepNotesIndication", {"Choose whether upper and lower case must match", "Alegeti daca literele mari si mici trebuie sa se potriveasca", "Elija si las mayusculas y minusculas deben coincidir"}},
+    {"deleteNoteAction", {"Delete note", "Stergeti notita", "Borrar nota"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"noteEditedSuccessfully", {"Note edited successfully", "Notita editata cu succes", "Nota editada con exito"}},
+    {"viewNotes", {"View notes", "Vizualizati notitele", "Ver notas"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"getInputDate", {"Enter date in format dd/mm/yyyy hh:mm", "introdu data in urmatorul format zz/ll/aaaa hh:mm", "introduzca fecha en formato dd/mm/yyyy hh:mm"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"getInputGrepPattern", {"Enter the text to find", "introdu textul cautat", "introduzca el texto a buscar"}},
+    {NULL, {NULL}},
+    {"noteListIndication", {"Use w and s to navigate, a and d to change page, g to go to a number, / to filter by title, press e to select", "Foloseste w si s pentru a naviga, a si d pentru a schimba pagina, g pentru a merge la un numar, / pentru a filtra dupa titlu, apasa e pentru a selecta", "Use w y s para navegar, a y d para cambiar de pagina, g para ir a un numero, / para filtrar por titulo, presione e para seleccionar"}},
+    {"viewNotesByDate", {"View notes by date", "Vizualizati notitele dupa data", "Ver notas por fecha"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"currentContent", {"Current content: #content (enter a new value or press enter to continue)", "Continutul curent: #content (introdu un nou continut sau apasa enter pentru a continua)", "Contenido actual: #content (introduzca un nuevo valor o presione enter para continuar)"}},
+    {NULL, {NULL}},
+    {"getInputNewNoteTitle", {"Enter new title:", "Introdu noul titlu:", "Introduzca nuevo titulo:"}},
+    {"getSystemDateFunction", {"Get system date", "Obtineti data sistemului", "Obtener fecha del sistema"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"deleteNoteActionTitle", {"Delete note", "Stergeti notita", "Borrar nota"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"dateInfo", {"Date info", "Informatii data", "Informacion de fecha"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"exit", {"Exit", "Iesire", "Salir"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"getInputNoteNumber", {"Enter the number of the note to go to (or press enter to stay)", "Introdu numarul notitei (sau apasa enter pentru a ramane)", "Introduzca el numero de la nota (o presione enter para quedarse)"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"editNoteActionTitle", {"Edit note ", " Editati notita", "Editar nota"}},
+    {"changeColorActionIndication", {"Please select a color", "Te rog selecteaza o culoare", "Por favor seleccione un color"}},
+    {"getDateActionTitle", {"Choose date option", "Alege o optiune pentru data", "Elija una opcion para la fecha"}},
+    {"noteListPosition", {"Notes #first-#last of #count", "Notitele #first-#last din #count", "Notas #first-#last de #count"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"settingsActionTitle", {"Settings", "Setari", "Configuraciones"}},
+    {"invalidInput", {"Invalid input", "Input invalid", "Input invalido"}},
+    {NULL, {NULL}},
+    {"getDateActionIndication", {"Select 'Add date' to add date manually or 'Get system date' to get system date", "Selectati 'Adaugati data' pentru a adauga manual data sau 'Obtineti data sistemului' pentru a obtine data sistemului", "Seleccione 'Anadir fecha' para anadir manualmente la fecha o 'Obtener fecha del sistema' para obtener la fecha del sistema"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"statsBytesPerNote", {"Bytes per note", "Octeti per notita", "Bytes por nota"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"currentDate", {"Current date: #date (enter a new value or press enter to continue)", "Data curenta: #date (introdu o noua data sau apasa enter pentru a continua)", "Fecha actual: #date (introduzca un nuevo valor o presione enter para continuar)"}},
+    {"getInputEndDate", {"Enter end date in format dd/mm/yyyy hh:mm", "introdu data de sfarsit in urmatorul format zz/ll/aaaa hh:mm", "introduzca fecha de fin en formato dd/mm/yyyy hh:mm"}},
+    {"firstMenuTitle", {"Note App", "Aplicatie Notite", "Aplicacion Notas"}},
+    {NULL, {NULL}},
+    {"content", {"Content: #content", "Continut #content", "Contenido #content"}},
+    {NULL, {NULL}},
+    {"time", {"Time #time", "ora #time", "hora #time"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"15", {"White", "Alb", "Blanco"}},
+    {"getInputStartDate", {"Enter start date in format dd/mm/yyyy hh:mm", "introdu data de inceput in urmatorul format zz/ll/aaaa hh:mm", "introduzca fecha de inicio en formato dd/mm/yyyy hh:mm"}},
+    {"changeLanguageActionTitle", {"Change Language", "Schimba Limba", "Cambiar idioma"}},
+    {"noteInfo", {"Note info", "Informatii notita", "Informacion de nota"}},
+    {"memoryStatsAction", {"Memory usage", "Utilizarea memoriei", "Uso de memoria"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"settingsAction", {"Settings", "Setari", "Configuraciones"}},
+    {NULL, {NULL}},
+    {"9", {"Blue", "Albastru", "Azul"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"noteAddedSuccessfully", {"Note added successfully", "Notita adaugata cu succes", "Nota anadida con exito"}},
+    {"notesExportFailed", {"Could not write notes.txt", "Nu s-a putut scrie notes.txt", "No se pudo escribir notes.txt"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"10", {"Green", "Verde", "Verde"}},
+    {"viewNotesByDateRange", {"View notes between two dates", "Vizualizati notitele intre doua date", "Ver notas entre dos fechas"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"currentTitle", {"Current title: #title (enter a new value or press enter to continue)", "Titlul curent: #title (introdu un nou titlu sau apasa enter pentru a continua)", "Titulo actual: #title (introduzca un nuevo valor o presione enter para continuar)"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"0", {"English", "Engleza", "Ingles"}},
+    {NULL, {NULL}},
+    {"noNotesFound", {"No notes found", "Nu s-au gasit notite", "No se han encontrado notas"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"noteSaveFailed", {"Could not save the change", "Modificarea nu a putut fi salvata", "No se pudo guardar el cambio"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"searchNotesAction", {"Search notes", "Cautati notite", "Buscar notas"}},
+    {NULL, {NULL}},
+    {"getInputNewNoteContent", {"Enter new content", "Introdu noul continut", "Introduzca nuevo contenido"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"grepIgnoreCase", {"Ignore case", "Ignorati literele mari si mici", "Ignorar mayusculas"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"statsIndexBytes", {"Indexes (bytes)", "Indexuri (octeti)", "Indices (bytes)"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"grepMatchCase", {"Match case", "Potriviti literele mari si mici", "Distinguir mayusculas"}},
+    {NULL, {NULL}},
+    {"addDateFunction", {"Add date", "Adaugati data", "Anadir fecha"}},
+    {"14", {"Yellow", "Galben", "Amarillo"}},
+    {"addNoteAction", {"Add note", "Adaugati notita", "Anadir nota"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"settingActionIndication", {"From here you can change the color of the app and the language", "De aici poti schimba culoarea si limba aplicatiei", "Desde aqui puede cambiar el color y el idioma de la aplicacion"}},
+    {"statsRecordBytes", {"Note records (bytes)", "Inregistrari notite (octeti)", "Registros de notas (bytes)"}},
+    {"getInputNoteTitle", {"Enter note title:", "Introdu titlu notitei:", "Introduzca titulo de nota:"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"grepNotesAction", {"Find text in notes", "Cautati text in notite", "Buscar texto en notas"}},
+    {"pressAnyKey", {"Press any key to continue...", "Apasa orice tasta pentru a continua...", "Presione cualquier tecla para continuar..."}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"notesExported", {"Notes exported to notes.txt", "Notitele au fost exportate in notes.txt", "Notas exportadas a notes.txt"}},
+    {"getInputNoteContent", {"Enter note content:", "Introdu continut notitei:", "Introduzca contenido de nota:"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"colorChangedSuccessfully", {"Color changed successfully", "Culoarea schimbata cu succes", "Color cambiado con exito"}},
+    {"statsNotes", {"Notes", "Notite", "Notas"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"getInputNewNoteDate", {"Enter new date in format dd/mm/yyyy hh:mm", "introdu noua data in urmatorul format zz/ll/aaaa hh:mm", "introduzca nueva fecha en formato dd/mm/yyyy hh:mm"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {"1", {"Romanian", "Romana", "Rumano"}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+    {NULL, {NULL}},
+};